@@ -5,6 +5,7 @@ in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords;
 in vec4 FragPosLightSpace;
+in vec3 ObjectColor; // [新增] 由顶点着色器传入（实例颜色或 objectColor）
 
 struct Material {
     sampler2D diffuse;
@@ -37,7 +38,6 @@ uniform vec3 viewPos;
 uniform DirLight dirLight;
 uniform PointLight pointLights[NR_POINT_LIGHTS];
 uniform Material material;
-uniform vec3 objectColor;
 uniform int useTexture;
 uniform sampler2D shadowMap;
 
@@ -51,7 +51,7 @@ void main()
     
     vec3 result = CalcDirLight(dirLight, norm, viewDir);
     
-    FragColor = vec4(result * objectColor, 1.0);
+    FragColor = vec4(result * ObjectColor, 1.0);
 }
 
 float ShadowCalculation(vec4 fragPosLightSpace, vec3 normal, vec3 lightDir)
@@ -1,10 +1,17 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
+// [新增] 实例化绘制的模型矩阵
+layout (location = 3) in mat4 aInstanceModel;
 
 uniform mat4 lightSpaceMatrix;
 uniform mat4 model;
+uniform bool instanced;
+
+// [新增] 压缩顶点的位置反量化（未压缩网格为 0 / 1）
+uniform vec3 quantOffset;
+uniform vec3 quantScale;
 
 void main()
 {
-    gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
+    gl_Position = lightSpaceMatrix * (instanced ? aInstanceModel : model) * vec4(quantOffset + aPos * quantScale, 1.0);
 }
@@ -2,22 +2,49 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
+// [新增] 实例化绘制的每实例属性（instanced 为 false 时使用 model / normalMatrix / objectColor）
+layout (location = 3) in mat4 aInstanceModel;
+layout (location = 7) in mat3 aInstanceNormal;
+layout (location = 10) in vec3 aInstanceColor;
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
 out vec4 FragPosLightSpace;
+out vec3 ObjectColor;
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 uniform mat3 normalMatrix;
 uniform mat4 lightSpaceMatrix;
+uniform vec3 objectColor;
+uniform bool instanced;
+
+// [新增] 压缩顶点格式：位置为相对包围盒的归一化值，法线为八面体编码
+// 未压缩网格 quantOffset = 0, quantScale = 1, quantized = false
+uniform bool quantized;
+uniform vec3 quantOffset;
+uniform vec3 quantScale;
+
+vec3 OctDecode(vec2 e)
+{
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = normalMatrix * aNormal;  
+    vec3 position = quantOffset + aPos * quantScale;
+    vec3 normal = quantized ? OctDecode(aNormal.xy) : aNormal;
+
+    mat4 modelMatrix = instanced ? aInstanceModel : model;
+    FragPos = vec3(modelMatrix * vec4(position, 1.0));
+    Normal = (instanced ? aInstanceNormal : normalMatrix) * normal;  
+    ObjectColor = instanced ? aInstanceColor : objectColor;
     TexCoords = aTexCoords;
     FragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
     
@@ -4,11 +4,18 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <string>
+#include <vector>
 
 #include "SceneContext.h"
 #include "Camera.h"
 #include "Shader.h"
 
+class ImportTask;
+namespace PartC
+{
+    class InstanceBatcher;
+}
+
 class Application {
 public:
     Application(const std::string& title, int width, int height);
@@ -38,6 +45,30 @@ private:
     char objPathBuffer[256] = "assets/models/teapot.obj";
     char texturePathBuffer[256] = "assets/textures/wood.png";
 
+    // [新增] 后台模型导入任务（同一时间只允许一个）
+    ImportTask* importTask = nullptr;
+    // [新增] 导入开始时源文件的版本（大小与修改时间），完成后用于登记网格
+    std::string importVersion;
+    // [新增] 流式导入（超大模型）：导入内存预算与分块常驻显存预算，单位 MB
+    bool streamingImport = false;
+    // [新增] 导入时使用 16 字节压缩顶点格式
+    bool packVertices = false;
+    // [新增] 导入时写入压缩的 .meshbin 缓存
+    bool compressCache = false;
+    int streamingBudgetMB = 512;
+    int residentBudgetMB = 256;
+
+    // [新增] 实例化合批（阴影与主渲染两个阶段复用）与本帧各对象的模型矩阵
+    PartC::InstanceBatcher* instanceBatcher = nullptr;
+    std::vector<glm::mat4> objectModels;
+
+    // [新增] 绘制调用基准：点击按钮后在下一帧主渲染末尾运行，结果显示在统计面板
+    static const int BENCHMARK_ROUNDS = 16;
+    bool benchmarkRequested = false;
+    size_t benchmarkDraws = 0;
+    size_t benchmarkBinds = 0;
+    double benchmarkNsPerDraw = 0.0;
+
     // 初始化
     bool InitGLFW();
     bool InitImGui();
@@ -48,9 +79,14 @@ private:
     void RenderUI();
     void RenderScene();
     void DeleteSelectedObject();
+    void PollImportTask();
+    // [新增] 逐对象重复提交普通网格 BENCHMARK_ROUNDS 轮，测量每次绘制的 CPU 耗时
+    void RunDrawBenchmark();
 
     // 射线检测算法
     void SelectObjectFromMouse(double xpos, double ypos);
+    // [新增] 对象的局部空间包围体（网格、分块网格或动态网格）
+    static BoundingVolume ObjectBounds(const SceneObject* obj);
     bool IntersectRayAABB(const glm::vec3& rayOrigin, const glm::vec3& rayDir, 
                           const glm::vec3& boxMin, const glm::vec3& boxMax, float& t);
     
@@ -0,0 +1,27 @@
+#ifndef BOUNDING_VOLUME_H
+#define BOUNDING_VOLUME_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+
+// [新增] 局部空间包围体：轴对齐包围盒 + 包围球
+// 网格构建时计算一次，释放 CPU 端顶点后仍保留，供拾取、视锥剔除、阴影范围与 LOD 选择使用
+struct BoundingVolume
+{
+    glm::vec3 min = glm::vec3(0.0f);
+    glm::vec3 max = glm::vec3(0.0f);
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = 0.0f;
+
+    // positions 指向第一个顶点的位置（3 个 float），相邻顶点相隔 stride 字节（stride >= 16）
+    // 包围盒由 SSE min/max 归约得到；球心取包围盒中心，半径为到最远顶点的距离（不大于半对角线）
+    static BoundingVolume FromPositions(const void* positions, size_t count, size_t stride);
+    // 只有包围盒时（压缩顶点、文件中给出的范围），半径取半对角线
+    static BoundingVolume FromBox(const glm::vec3& min, const glm::vec3& max);
+
+    glm::vec3 Size() const { return max - min; }
+    // 经模型矩阵变换后的包围球（半径按最大轴缩放放大）
+    void WorldSphere(const glm::mat4& model, glm::vec3& worldCenter, float& worldRadius) const;
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define COMMON_H
 
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -13,6 +14,29 @@ struct Vertex
     glm::vec2 TexCoords;
 };
 
+// [新增] 压缩顶点结构（16 字节）
+// 位置：相对网格包围盒的 16 位归一化整数（第 4 个分量仅用于对齐）
+// 法线：八面体编码的 2 个 16 位有符号归一化整数
+// 纹理坐标：2 个半精度浮点数
+struct PackedVertex
+{
+    uint16_t Position[4];
+    int16_t Normal[2];
+    uint16_t TexCoords[2];
+};
+
+// [新增] 深度渲染用的紧凑位置流（与交错顶点按相同下标一一对应）
+struct PositionVertex
+{
+    glm::vec3 Position;
+};
+
+// [新增] 压缩网格的位置流：与 PackedVertex::Position 相同的 16 位量化位置
+struct PackedPosition
+{
+    uint16_t Position[4];
+};
+
 // Texture definition moved to Texture.h
 
 #endif
\ No newline at end of file
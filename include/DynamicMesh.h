@@ -0,0 +1,66 @@
+#ifndef DYNAMIC_MESH_H
+#define DYNAMIC_MESH_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+#include "BoundingVolume.h"
+#include "Common.h"
+#include "Material.h"
+#include "Shader.h"
+#include "Texture.h"
+
+// DynamicMesh 类：每帧由 CPU 改写顶点的网格（形变、变形动画），索引（拓扑）固定
+// 顶点缓冲分为 RING_SIZE 段轮流写入，每段被绘制后插入 glFenceSync，再次写入同一段前等待该栅栏
+// 支持 glBufferStorage 时整个缓冲持久映射，CPU 直接写入映射内存；
+// 否则写入 CPU 暂存区，EndUpdate 时孤立旧存储（glBufferData 空指针）后上传
+class DynamicMesh {
+public:
+    static const unsigned int RING_SIZE = 3;
+
+    // vertices 为初始顶点（之后每次更新都写入同样数量的顶点）
+    DynamicMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+    ~DynamicMesh();
+    DynamicMesh(const DynamicMesh&) = delete;
+    DynamicMesh& operator=(const DynamicMesh&) = delete;
+
+    // 返回本次可写入的 VertexCount() 个顶点（只写不读：持久映射的内存读取很慢）
+    Vertex* BeginUpdate();
+    // 写入完成，之后的 Draw 使用新顶点
+    void EndUpdate();
+
+    void Draw(Shader& shader, const Material* material = nullptr);
+    // 深度渲染：不绑定纹理（顶点每帧改写，不另建位置流，读取同一个交错缓冲）
+    void DrawDepth(Shader& shader);
+
+    bool IsPersistent() const { return mapped != nullptr; }
+    size_t VertexCount() const { return vertexCount; }
+    // BeginUpdate 时目标段仍在被 GPU 使用、需要等待的次数
+    size_t StallCount() const { return stalls; }
+
+    // 包围体由写入方维护（覆盖整个形变范围，不随每帧顶点重算）
+    BoundingVolume bounds;
+
+private:
+    unsigned int VAO = 0, VBO = 0, EBO = 0;
+    size_t vertexCount = 0;
+    GLsizei indexCount = 0;
+    GLenum indexType = GL_UNSIGNED_INT; // 顶点数允许时为 16 位
+
+    // writeSection：BeginUpdate 取得的段；drawSection：最近一次写完、Draw 使用的段
+    unsigned int writeSection = 0;
+    unsigned int drawSection = 0;
+    GLsync fences[RING_SIZE] = {};
+    size_t stalls = 0;
+
+    Vertex* mapped = nullptr;     // 持久映射的起点（RING_SIZE 段）
+    std::vector<Vertex> staging;  // 无持久映射时的暂存区
+
+    bool CreatePersistentBuffer(const std::vector<Vertex>& vertices);
+    void WaitFence(unsigned int section);
+    // 绘制当前段并为其插入栅栏
+    void Submit();
+};
+
+#endif
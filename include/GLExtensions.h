@@ -0,0 +1,55 @@
+#ifndef GL_EXTENSIONS_H
+#define GL_EXTENSIONS_H
+
+#include <glad/glad.h>
+
+// glad 只生成了 GL 3.3 核心函数，4.x 的函数与常量在这里补充
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+typedef void(APIENTRYP GLMultiDrawElementsIndirectProc)(GLenum mode, GLenum type, const void *indirect,
+                                                        GLsizei drawCount, GLsizei stride);
+typedef void(APIENTRYP GLBufferStorageProc)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+
+// [新增] glMultiDrawElementsIndirect 的一条命令（布局由 GL 规定）
+struct DrawElementsIndirectCommand
+{
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+// GLExtensions 类：按上下文版本（或扩展）加载可选的 GL 函数
+// 在 gladLoadGLLoader 之后调用 Load；不可用时对应的函数指针为空，调用方走 3.3 路径
+class GLExtensions {
+public:
+    static void Load(GLADloadproc loader);
+
+    static int MajorVersion() { return majorVersion; }
+    static int MinorVersion() { return minorVersion; }
+
+    // GL 4.3 或 ARB_multi_draw_indirect（baseInstance 需要 4.2 或 ARB_base_instance）
+    static bool HasMultiDrawIndirect() { return MultiDrawElementsIndirect != nullptr; }
+    // [新增] GL 4.4 或 ARB_buffer_storage（不可变存储，可持久映射）
+    static bool HasBufferStorage() { return BufferStorage != nullptr; }
+
+    static GLMultiDrawElementsIndirectProc MultiDrawElementsIndirect;
+    static GLBufferStorageProc BufferStorage;
+
+private:
+    static int majorVersion;
+    static int minorVersion;
+
+    static bool HasExtension(const char *name);
+};
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef GEOMETRY_ARENA_H
+#define GEOMETRY_ARENA_H
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+// [新增] 区间分配器：按起始位置记录空闲区间，首次适配分配，释放时与相邻空闲区间合并
+class RangeAllocator {
+public:
+    bool Allocate(size_t size, size_t& offset);
+    void Free(size_t offset, size_t size);
+    // 容量增加到 capacity，新增部分并入空闲区间
+    void Grow(size_t capacity);
+
+    size_t Capacity() const { return capacity; }
+    size_t Used() const { return used; }
+    size_t FreeRangeCount() const { return freeRanges.size(); }
+
+private:
+    std::map<size_t, size_t> freeRanges; // 起始位置 -> 长度
+    size_t capacity = 0;
+    size_t used = 0;
+};
+
+// [新增] 网格在几何池中的区间（单位为顶点 / 索引个数）
+// firstIndex 以本网格的索引宽度 indexSize（2 或 4 字节）为单位
+struct GeometryRange {
+    unsigned int baseVertex = 0;
+    unsigned int vertexCount = 0;
+    unsigned int firstIndex = 0;
+    unsigned int indexCount = 0;
+    unsigned int indexSize = 4;
+};
+
+// GeometryArena 类：同一顶点格式的所有网格共用一个大 VBO / EBO 与一个 VAO
+// 每个 Mesh 只占其中一段，用 glDrawElementsBaseVertex 绘制，切换网格不再需要绑定 VAO
+// 空间不足时按倍数扩容（glCopyBufferSubData 在 GPU 端搬运旧数据），已有网格的区间不变
+// [新增] 16 位与 32 位索引的网格共用一个 EBO：索引区按 4 字节字分配，保证两种宽度的起点都对齐
+// [新增] 另有一个只含位置的紧凑顶点流（与交错顶点下标相同）和只读取它的深度 VAO，供阴影等深度渲染使用
+class GeometryArena {
+public:
+    enum Format {
+        FORMAT_VERTEX, // Vertex（32 字节）
+        FORMAT_PACKED, // PackedVertex（16 字节）
+        FORMAT_COUNT
+    };
+
+    static const size_t INITIAL_VERTICES = 1 << 16;
+    static const size_t INITIAL_INDEX_WORDS = 1 << 18;
+
+    // 按格式取得共享的池（首次使用时创建，需在 GL 上下文线程调用）
+    static GeometryArena& Get(Format format);
+    // 删除全部池的 GL 对象（在销毁上下文前、所有 Mesh 释放后调用）
+    static void DestroyAll();
+
+    // 绑定 VAO；与当前绑定相同时跳过（所有 Mesh 都经由这里绑定）
+    static void BindVertexArray(unsigned int vao);
+    // VAO 被删除时调用，使绑定缓存失效
+    static void ForgetVertexArray(unsigned int vao);
+
+    // 分配并上传一个网格，索引为网格内的局部下标，indexSize 为每个索引的字节数（2 或 4）
+    bool Allocate(const void* vertexData, size_t vertexCount, const void* indexData, size_t indexCount,
+                  size_t indexSize, GeometryRange& range);
+    void Free(const GeometryRange& range);
+
+    unsigned int VertexArray() const { return vao; }
+    // 深度 VAO：属性 0 指向位置流，EBO 与 VertexArray() 相同
+    unsigned int DepthVertexArray() const { return depthVao; }
+    size_t VertexStride() const { return stride; }
+    size_t PositionStride() const { return positionStride; }
+    size_t VertexCapacity() const { return vertices.Capacity(); }
+    size_t VertexUsed() const { return vertices.Used(); }
+    size_t IndexBytesCapacity() const { return indexWords.Capacity() * INDEX_WORD; }
+    size_t IndexBytesUsed() const { return indexWords.Used() * INDEX_WORD; }
+    // 当前显存占用（字节）
+    size_t GpuBytes() const { return vertices.Capacity() * (stride + positionStride) + IndexBytesCapacity(); }
+
+private:
+    explicit GeometryArena(Format format);
+    ~GeometryArena();
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+    Format format;
+    size_t stride;
+    size_t positionStride;
+    unsigned int vao = 0, vbo = 0, ebo = 0;
+    unsigned int depthVao = 0, positionVbo = 0;
+    RangeAllocator vertices;
+    RangeAllocator indexWords; // 单位为 INDEX_WORD 字节
+
+    static const size_t INDEX_WORD = 4;
+    static size_t IndexWords(size_t indexCount, size_t indexSize)
+    {
+        return (indexCount * indexSize + INDEX_WORD - 1) / INDEX_WORD;
+    }
+
+    // 创建 newBytes 大小的新缓冲并复制旧缓冲的 oldBytes 字节，旧缓冲随即删除
+    static unsigned int GrowBuffer(unsigned int buffer, size_t oldBytes, size_t newBytes);
+    void SetupVertexArray();
+    // 从交错顶点中抽出位置写入 storage，返回其数据指针
+    const void* ExtractPositions(const void* vertexData, size_t vertexCount, std::vector<unsigned char>& storage) const;
+
+    static GeometryArena* arenas[FORMAT_COUNT];
+    static unsigned int boundVertexArray;
+};
+
+#endif
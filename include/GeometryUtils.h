@@ -3,12 +3,18 @@
 
 #include "Mesh.h"
 
+class DynamicMesh;
+
 // GeometryUtils 类：负责程序化生成基础几何体
 // 职责：[Part C] 负责实现球体、立方体等的数学生成算法
 class GeometryUtils {
 public:
     static Mesh* CreateCube();
     static Mesh* CreateSphere(int latitudeSegments, int longitudeSegments);
+    // [新增] 动态波浪网格：resolution × resolution 个格子，铺满 XZ 平面的 [-0.5, 0.5]
+    static DynamicMesh* CreateWaveGrid(int resolution);
+    // [新增] 按时间重写波浪网格的全部顶点（按行并行写入）
+    static void UpdateWaveGrid(DynamicMesh* mesh, int resolution, float time);
     // [Part C] TODO: 添加圆柱、圆锥等接口
 };
 
@@ -0,0 +1,58 @@
+#ifndef GLTF_LOADER_H
+#define GLTF_LOADER_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Mesh.h"
+#include "MappedFile.h"
+
+struct ImportProgress;
+
+// glTF 场景中的一个图元实例（节点 × 图元）
+struct GltfPrimitive {
+    std::string name;
+    glm::mat4 transform = glm::mat4(1.0f); // 节点的世界矩阵
+    glm::vec3 color = glm::vec3(1.0f);     // 材质的 baseColorFactor
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+
+    // direct：属性为 float VEC3/VEC3/VEC2 且带索引，layout 直接引用 BIN 块中的区间
+    bool direct = false;
+    MeshBufferLayout layout;
+    size_t vertexCount = 0;
+
+    // 布局不匹配（整数/归一化分量、缺少法线、无索引等）时转换得到的 CPU 数据
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+};
+
+// 导入结果：保持 GLB 文件映射，BIN 块在主线程整块上传一次，所有 direct 图元共享这个缓冲
+struct GltfModel {
+    MappedFile file;
+    const char* binary = nullptr;
+    size_t binarySize = 0;
+    std::vector<GltfPrimitive> primitives;
+};
+
+// GltfLoader 类：读取 glTF 2.0 二进制容器 (.glb)
+// 只使用第一个 scene 中节点引用的三角形图元（mode 4）的 POSITION / NORMAL / TEXCOORD_0；
+// 不支持外部 .bin、data URI、稀疏访问器与压缩扩展
+class GltfLoader {
+public:
+    // 文件头魔数 "glTF"
+    static bool IsGlb(const char* data, size_t size);
+
+    // 不调用 GL 函数，可在后台线程执行
+    static bool Load(const std::string& path, GltfModel& out, ImportProgress* progress = nullptr);
+
+    // 在 GL 线程创建网格，与 model.primitives 一一对应
+    static std::vector<Mesh*> CreateMeshes(const GltfModel& model);
+
+    // 把节点矩阵分解为 SceneObject 的平移 / 欧拉角（度，按 X、Y、Z 依次旋转）/ 缩放
+    static void DecomposeTransform(const glm::mat4& transform, glm::vec3& position, glm::vec3& rotationDegrees,
+                                   glm::vec3& scale);
+};
+
+#endif
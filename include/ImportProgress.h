@@ -0,0 +1,35 @@
+#ifndef IMPORT_PROGRESS_H
+#define IMPORT_PROGRESS_H
+
+#include <atomic>
+
+// 导入进度与取消标志：后台导入线程写入，UI 线程读取
+// 每个阶段占总进度的一段区间，阶段内部只需报告 0~1 的局部进度
+struct ImportProgress {
+    std::atomic<float> fraction{0.0f};
+    // 当前阶段的描述，只能指向静态字符串
+    std::atomic<const char*> stage{"Queued"};
+    std::atomic<bool> cancelled{false};
+
+    bool IsCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+    // 须在阶段的并行任务开始前调用
+    void BeginStage(const char* name, float start, float span)
+    {
+        stageStart = start;
+        stageSpan = span;
+        stage.store(name, std::memory_order_relaxed);
+        fraction.store(start, std::memory_order_relaxed);
+    }
+
+    void Report(float stageFraction)
+    {
+        fraction.store(stageStart + stageSpan * stageFraction, std::memory_order_relaxed);
+    }
+
+private:
+    float stageStart = 0.0f;
+    float stageSpan = 1.0f;
+};
+
+#endif
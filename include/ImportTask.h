@@ -0,0 +1,58 @@
+#ifndef IMPORT_TASK_H
+#define IMPORT_TASK_H
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include "GltfLoader.h"
+#include "ImportProgress.h"
+#include "ModelLoader.h"
+#include "StreamingImporter.h"
+
+// ImportTask 类：在后台线程执行 ModelLoader::LoadMeshData
+// 解析期间主循环照常渲染；完成后由主线程取出 Result() 调用 CreateMesh 上传
+// 传入 streaming 时改为执行 StreamingImporter::Import，结果由 TakeChunkedMesh() 取出
+// .glb 文件执行 GltfLoader::Load，结果由 GltfResult() 取出后调用 GltfLoader::CreateMeshes
+class ImportTask {
+public:
+    ImportTask(const std::string& path, const ImportOptions& options, const StreamingOptions* streaming = nullptr);
+    // 析构时请求取消并等待后台线程退出
+    ~ImportTask();
+
+    ImportTask(const ImportTask&) = delete;
+    ImportTask& operator=(const ImportTask&) = delete;
+
+    const std::string& Path() const { return path; }
+    float Progress() const { return progress.fraction.load(std::memory_order_relaxed); }
+    const char* Stage() const { return progress.stage.load(std::memory_order_relaxed); }
+
+    void Cancel() { progress.cancelled.store(true); }
+    bool IsCancelled() const { return progress.IsCancelled(); }
+
+    bool IsFinished() const { return finished.load(std::memory_order_acquire); }
+    // 仅在 IsFinished() 之后有效
+    bool Succeeded() const { return succeeded; }
+    MeshData& Result() { return data; }
+
+    bool IsStreaming() const { return streaming; }
+    bool IsGltf() const { return gltf; }
+    GltfModel& GltfResult() { return gltfModel; }
+    // 转移分块网格的所有权给调用者
+    ChunkedMesh* TakeChunkedMesh();
+
+private:
+    std::string path;
+    ImportProgress progress;
+    ImportOptions options;
+    MeshData data;
+    bool streaming = false;
+    StreamingOptions streamingOptions;
+    bool gltf = false;
+    GltfModel gltfModel;
+    ChunkedMesh* chunkedMesh = nullptr;
+    bool succeeded = false;
+    std::atomic<bool> finished{false};
+    std::thread worker;
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef INDEX_FORMAT_H
+#define INDEX_FORMAT_H
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// IndexFormat 类：按顶点数选择索引宽度（16 / 32 位）以及两种宽度之间的转换
+// CPU 端处理（优化、LOD、网格簇）统一使用 32 位索引，只在上传与写缓存时收窄
+class IndexFormat {
+public:
+    // 顶点数不超过该值时使用 16 位索引（不启用图元重启，65535 也是合法下标）
+    static const size_t MAX_SHORT_VERTICES = 65536;
+
+    // GL_UNSIGNED_SHORT 或 GL_UNSIGNED_INT
+    static GLenum Select(size_t vertexCount);
+    static size_t Size(GLenum type);
+
+    // 32 位 -> 16 位，调用方保证所有索引小于 MAX_SHORT_VERTICES
+    static void Narrow(const unsigned int* source, size_t count, uint16_t* destination);
+    // 16 位 -> 32 位
+    static void Widen(const uint16_t* source, size_t count, unsigned int* destination);
+    // 最大下标（type 为 GL_UNSIGNED_SHORT / INT），count 为 0 时返回 0；用于校验外部数据
+    static unsigned int MaxIndex(const void* indices, size_t count, GLenum type);
+
+    // 按 vertexCount 选择宽度并转换；选中 32 位时 storage 为空，直接使用 source
+    // 返回要上传的数据指针（指向 source 或 storage）
+    static const void* Prepare(const unsigned int* source, size_t count, size_t vertexCount,
+                               std::vector<uint16_t>& storage, GLenum& type);
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef INSTANCE_BATCHER_H
+#define INSTANCE_BATCHER_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Mesh.h"
+#include "Shader.h"
+#include "VertexFormat.h"
+
+namespace PartC
+{
+    // [新增] 每实例数据，布局与着色器中的实例属性一致
+    struct InstanceData
+    {
+        glm::mat4 model;
+        glm::mat3 normalMatrix;
+        glm::vec3 color;
+    };
+
+    // InstanceBatcher 类：把共享网格（及纹理、LOD）的对象合并为一次 glDrawElementsInstanced
+    // 每帧 Begin -> Add ... -> Flush；全部实例写入同一个流式缓冲，一次上传，各组按偏移设置实例属性
+    // 只有一个实例的组仍按原路径逐个绘制（保留逐簇剔除）
+    // [新增] 支持多重间接绘制时，同一 VAO 与纹理（压缩网格还需反量化参数相同）的全部对象写成一组命令，
+    //        一次 glMultiDrawElementsIndirect 提交
+    //        每条命令的 baseInstance 指向该组在实例缓冲中的起点，着色器仍用原有的实例属性
+    class InstanceBatcher
+    {
+    public:
+        // 实例属性位置：模型矩阵占 3..6，法线矩阵占 7..9，颜色为 10
+        static const unsigned int ATTRIBUTE_MODEL = 3;
+        static const unsigned int ATTRIBUTE_NORMAL = 7;
+        static const unsigned int ATTRIBUTE_COLOR = 10;
+        static const size_t MIN_GROUP_SIZE = 2;
+
+        InstanceBatcher() = default;
+        ~InstanceBatcher();
+        InstanceBatcher(const InstanceBatcher &) = delete;
+        InstanceBatcher &operator=(const InstanceBatcher &) = delete;
+
+        void Begin();
+        // 网格不在几何池中时（glTF 共享缓冲网格有各自的 VAO）返回 false，由调用方直接绘制
+        bool Add(Mesh *mesh, int lod, const Material *material, const glm::mat4 &model, const glm::vec3 &color);
+        // 主渲染：设置颜色与法线矩阵并绑定纹理
+        void Flush(Shader &shader);
+        // 深度渲染：只需要模型矩阵
+        void FlushDepth(Shader &shader);
+
+    private:
+        struct Item
+        {
+            Mesh *mesh;
+            int lod;
+            unsigned int diffuse, specular; // 纹理 id，构成分组键的一部分
+            const Material *material;
+            glm::mat4 model;
+            glm::vec3 color;
+        };
+
+        std::vector<Item> items;
+        std::vector<uint32_t> order;
+        std::vector<InstanceData> instances;
+        std::vector<DrawElementsIndirectCommand> commands;
+        unsigned int buffer = 0;
+        size_t capacity = 0; // 字节
+        unsigned int indirectBuffer = 0;
+        size_t indirectCapacity = 0; // 字节
+
+        void Submit(Shader &shader, bool depth);
+        void SubmitIndirect(Shader &shader, bool depth);
+        void AppendInstances(size_t begin, size_t end, bool depth);
+        void Upload();
+        void UploadCommands();
+        // 重新分配（孤立旧存储）后写入 bytes 字节，capacity 按需翻倍
+        static void UploadStream(GLenum target, unsigned int &buffer, size_t &capacity, const void *data, size_t bytes);
+        void BindInstanceAttributes(size_t firstInstance);
+        static void UnbindInstanceAttributes();
+    };
+}
+
+// [新增] 实例布局：矩阵按列拆成多个属性，每实例步进一次
+template <>
+struct VertexLayout<PartC::InstanceData>
+{
+    using InstanceData = PartC::InstanceData;
+    using InstanceBatcher = PartC::InstanceBatcher;
+    static constexpr GLuint divisor = 1;
+    static constexpr std::array<VertexAttribute, 8> attributes = {{
+        {InstanceBatcher::ATTRIBUTE_MODEL + 0, 4, GL_FLOAT, GL_FALSE, offsetof(InstanceData, model) + 0 * sizeof(glm::vec4), "aInstanceModel"},
+        {InstanceBatcher::ATTRIBUTE_MODEL + 1, 4, GL_FLOAT, GL_FALSE, offsetof(InstanceData, model) + 1 * sizeof(glm::vec4), nullptr},
+        {InstanceBatcher::ATTRIBUTE_MODEL + 2, 4, GL_FLOAT, GL_FALSE, offsetof(InstanceData, model) + 2 * sizeof(glm::vec4), nullptr},
+        {InstanceBatcher::ATTRIBUTE_MODEL + 3, 4, GL_FLOAT, GL_FALSE, offsetof(InstanceData, model) + 3 * sizeof(glm::vec4), nullptr},
+        {InstanceBatcher::ATTRIBUTE_NORMAL + 0, 3, GL_FLOAT, GL_FALSE, offsetof(InstanceData, normalMatrix) + 0 * sizeof(glm::vec3), "aInstanceNormal"},
+        {InstanceBatcher::ATTRIBUTE_NORMAL + 1, 3, GL_FLOAT, GL_FALSE, offsetof(InstanceData, normalMatrix) + 1 * sizeof(glm::vec3), nullptr},
+        {InstanceBatcher::ATTRIBUTE_NORMAL + 2, 3, GL_FLOAT, GL_FALSE, offsetof(InstanceData, normalMatrix) + 2 * sizeof(glm::vec3), nullptr},
+        {InstanceBatcher::ATTRIBUTE_COLOR, 3, GL_FLOAT, GL_FALSE, offsetof(InstanceData, color), "aInstanceColor"},
+    }};
+};
+static_assert(VertexFormat::IsValid<PartC::InstanceData>(), "InstanceData layout");
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef JSON_VALUE_H
+#define JSON_VALUE_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// JsonValue 类：最小的 JSON DOM，用于读取 glTF 等描述文件
+// 对象按出现顺序保存键值对（描述文件的键数很少，线性查找即可）
+class JsonValue {
+public:
+    enum class Type {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    // 解析 [begin, end)，失败时返回 false 并在 error 中给出出错位置
+    static bool Parse(const char* begin, const char* end, JsonValue& out, std::string* error = nullptr);
+
+    bool IsNumber() const { return type == Type::Number; }
+    bool IsArray() const { return type == Type::Array; }
+    bool IsObject() const { return type == Type::Object; }
+
+    // 对象成员，不存在或不是对象时返回 nullptr
+    const JsonValue* Find(const char* key) const;
+    // 数组长度（非数组为 0）与元素访问
+    size_t Size() const { return type == Type::Array ? array.size() : 0; }
+    const JsonValue& operator[](size_t index) const { return array[index]; }
+
+    // 读取成员的便捷函数：成员不存在或类型不符时返回 fallback
+    double Number(const char* key, double fallback) const;
+    const std::string& String(const char* key) const;
+};
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// MappedFile 类：只读内存映射文件（mmap / CreateFileMapping）
+// 用于大模型导入，避免 iostream 逐字节读取和整文件拷贝
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // 映射整个文件，失败返回 false（空文件同样视为失败）
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return data != nullptr; }
+    const char* Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+#endif
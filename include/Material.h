@@ -0,0 +1,46 @@
+#ifndef MATERIAL_H
+#define MATERIAL_H
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <vector>
+#include "Shader.h"
+#include "Texture.h"
+
+// [新增] Material 类：一组纹理在创建时按类型解析为固定的纹理单元与 useTexture 标志
+// 绘制时不再做字符串比较与 uniform 查找，只绑定与当前状态不同的纹理（全局记录各单元已绑定的纹理）
+// 采样器 uniform 固定指向 UNIT_DIFFUSE / UNIT_SPECULAR，每个着色器程序只设置一次
+class Material
+{
+public:
+    static const unsigned int UNIT_DIFFUSE = 0;
+    static const unsigned int UNIT_SPECULAR = 1;
+    static const unsigned int UNIT_COUNT = 2;
+
+    // 无纹理（useTexture = 0）
+    Material() = default;
+    // 每种类型取第一张纹理；没有高光贴图时复用漫反射贴图
+    explicit Material(const std::vector<Texture> &textures);
+
+    // 设置 useTexture 并绑定纹理；shader 须为当前使用的程序
+    void Bind(Shader &shader) const;
+
+    bool HasTextures() const { return useTexture; }
+    unsigned int Diffuse() const { return textureIds[UNIT_DIFFUSE]; }
+    unsigned int Specular() const { return textureIds[UNIT_SPECULAR]; }
+
+    // 每帧开始时调用：其他代码（ImGui、纹理加载）可能改动了纹理单元，清空绑定记录并清零统计
+    static void BeginFrame();
+    // 本帧实际发出的 glBindTexture 次数与因已绑定而省去的次数
+    static size_t textureBinds;
+    static size_t bindsSkipped;
+
+private:
+    unsigned int textureIds[UNIT_COUNT] = {};
+    bool useTexture = false;
+
+    static const unsigned int UNKNOWN_TEXTURE = ~0u;
+    static unsigned int boundTextures[UNIT_COUNT];
+};
+
+#endif
@@ -3,29 +3,189 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <memory>
 #include <vector>
 #include <string>
 #include "Shader.h"
 #include "Common.h"
 #include "Texture.h"
+#include "Material.h"
+#include "Meshlet.h"
+#include "VertexPacker.h"
+#include "GeometryArena.h"
+#include "BoundingVolume.h"
+#include "GLExtensions.h"
+
+// [新增] 一级 LOD：共享同一个顶点缓冲，对应索引缓冲中的一段
+struct MeshLod
+{
+    unsigned int indexOffset;
+    unsigned int indexCount;
+    float error; // 简化误差，相对包围盒对角线
+};
+
+// [新增] 多个 Mesh 共用的 GL 缓冲（例如整个 glTF BIN 块），最后一个引用释放时删除
+class SharedBuffer
+{
+public:
+    SharedBuffer(const void *data, size_t bytes);
+    ~SharedBuffer();
+    SharedBuffer(const SharedBuffer &) = delete;
+    SharedBuffer &operator=(const SharedBuffer &) = delete;
+
+    unsigned int Id() const { return id; }
+    size_t Size() const { return size; }
+
+private:
+    unsigned int id = 0;
+    size_t size = 0;
+};
+
+// [新增] 共享缓冲中的非交错顶点属性与索引区间（字节偏移与跨度）
+struct MeshBufferLayout
+{
+    static const size_t NO_ATTRIBUTE = ~static_cast<size_t>(0);
+
+    size_t positionOffset = 0;
+    unsigned int positionStride = sizeof(glm::vec3);
+    size_t normalOffset = 0;
+    unsigned int normalStride = sizeof(glm::vec3);
+    size_t texCoordOffset = NO_ATTRIBUTE;
+    unsigned int texCoordStride = sizeof(glm::vec2);
+
+    size_t indexOffset = 0;
+    size_t indexCount = 0;
+    GLenum indexType = GL_UNSIGNED_INT; // GL_UNSIGNED_BYTE / SHORT / INT
+};
+
+// [新增] 上传后是否保留 CPU 端的 vertices / indices
+// 静态网格只需要包围盒（拾取、剔除、LOD 选择），释放后主机内存约减半
+enum class MeshResidency
+{
+    KeepCpuData,
+    ReleaseAfterUpload
+};
 
 // Mesh 类：负责存储几何数据和渲染
 // 职责：[Part C] 负责维护此类的内部实现（VAO/VBO管理）
+// [新增] 交错格式（Vertex / PackedVertex）的网格从 GeometryArena 分配一段区间，共用 VAO；
+// 共享缓冲（glTF）的网格属性布局各不相同，仍使用自己的 VAO
 class Mesh
 {
 public:
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
     std::vector<Texture> textures;
+    // [新增] 由 textures 在构造时解析的材质（绘制时使用它，不再逐次查看 textures）
+    Material material;
+
+    // [新增] LOD 链（lods[0] 为原网格，由细到粗）；为空时绘制全部索引
+    std::vector<MeshLod> lods;
+    // [新增] 局部空间包围盒与包围球（构建时计算，ReleaseCpuData 后仍保留）
+    BoundingVolume bounds;
+    // [新增] LOD0 的网格簇，用于逐簇视锥与背面剔除；为空时只能整体绘制
+    std::vector<Meshlet> meshlets;
+
+    // 参数按值传入后移动到成员，调用方可 std::move 以避免拷贝
+    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures,
+         MeshResidency residency = MeshResidency::KeepCpuData);
+
+    // [新增] 直接从外部内存上传（例如内存映射的缓存文件），不保留 CPU 端拷贝
+    // indexType 为 indexData 的宽度（GL_UNSIGNED_SHORT / INT）；顶点数允许时 32 位索引上传前自动收窄为 16 位
+    // bounds 由调用方给出（导入时已算好或来自文件头），构造时不再扫描顶点
+    Mesh(const Vertex *vertexData, size_t vertexCount, const void *indexData, size_t indexCount, GLenum indexType,
+         const BoundingVolume &bounds, std::vector<Texture> textures);
+
+    // [新增] 压缩顶点格式（16 字节/顶点），位置按 quantization 在着色器中反量化
+    Mesh(const PackedVertex *vertexData, size_t vertexCount, const void *indexData, size_t indexCount,
+         GLenum indexType, const VertexQuantization &quantization, const BoundingVolume &bounds,
+         std::vector<Texture> textures);
+
+    // [新增] 共享缓冲上的网格：属性与索引直接指向 buffer 中的区间，不复制、不拥有缓冲数据
+    Mesh(std::shared_ptr<SharedBuffer> buffer, const MeshBufferLayout &layout, std::vector<Texture> textures);
+
+    // [新增] 释放 VAO/VBO/EBO（流式导入会频繁创建和销毁块网格）
+    ~Mesh();
+    Mesh(const Mesh &) = delete;
+    Mesh &operator=(const Mesh &) = delete;
+
+    // 渲染网格（lod 超出范围时按最粗一级处理）
+    // [新增] material 非空时代替网格自带的材质（共享网格的对象各自设置纹理）
+    void Draw(Shader &shader, int lod = 0, const Material *material = nullptr);
+
+    // [新增] 实例化绘制：实例属性（位置 3 起）由调用方在本网格的 VAO 上设置
+    void DrawInstanced(Shader &shader, int lod, GLsizei instanceCount, const Material *material = nullptr);
 
-    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures);
+    // [新增] 本网格 lod 级的间接绘制命令（firstIndex / baseVertex 为几何池中的位置）
+    DrawElementsIndirectCommand IndirectCommand(int lod, GLuint instanceCount, GLuint baseInstance) const;
+    // [新增] 提交 GL_DRAW_INDIRECT_BUFFER 中 offset 起的 drawCount 条命令
+    // 命令可以引用同一几何池中的任意网格；材质与顶点格式 uniform 取自本网格
+    void DrawIndirect(Shader &shader, size_t offset, GLsizei drawCount, const Material *material = nullptr);
 
-    // 渲染网格
-    void Draw(Shader &shader);
+    // [新增] 深度绘制（阴影、预深度）：只读取紧凑的位置流，不绑定纹理、不设置材质 uniform
+    void DrawDepth(Shader &shader, int lod = 0);
+    void DrawDepthInstanced(Shader &shader, int lod, GLsizei instanceCount);
+    void DrawDepthIndirect(Shader &shader, size_t offset, GLsizei drawCount);
+
+    // [新增] 只绘制 LOD0 中通过视锥与法线锥测试的簇（planes / cameraLocal 为模型局部空间）
+    // 返回可见簇数，visibleTriangles 输出提交的三角形数
+    unsigned int DrawClusters(Shader &shader, const glm::vec4 *planes, const glm::vec3 &cameraLocal,
+                              unsigned int &visibleTriangles, const Material *material = nullptr);
+
+    // [新增] 释放 CPU 端的顶点与索引（GPU 缓冲与包围盒保留）
+    void ReleaseCpuData();
+    bool HasCpuData() const { return !vertices.empty() || !indices.empty(); }
+
+    bool IsPacked() const { return packed; }
+    // [新增] 压缩网格的反量化参数（未压缩网格为恒等参数）
+    const VertexQuantization &Quantization() const { return quantization; }
+    size_t VertexStride() const { return packed ? sizeof(PackedVertex) : sizeof(Vertex); }
+
+    GLenum IndexType() const { return indexType; }
+    unsigned int VertexArray() const { return VAO; }
+    // [新增] 深度绘制使用的 VAO（几何池的位置流；共享缓冲网格的位置本就是独立属性，与 VAO 相同）
+    unsigned int DepthVertexArray() const { return depthVAO; }
+    // [新增] 所在的几何池与区间（未使用几何池时 arena 为空）
+    const GeometryArena* Arena() const { return arena; }
+    const GeometryRange& ArenaRange() const { return arenaRange; }
+
+    // [新增] 设置顶点格式相关的 uniform（quantized 与反量化参数）；未压缩顶点传恒等参数
+    // 着色器总是计算 quantOffset + aPos * quantScale，不属于几何池的网格（DynamicMesh）也须设置
+    static void SetQuantization(Shader &shader, bool packed, const VertexQuantization &quantization);
+
+    int LodCount() const { return lods.empty() ? 1 : static_cast<int>(lods.size()); }
+    unsigned int LodIndexCount(int lod) const;
 
 private:
-    unsigned int VAO, VBO, EBO;
-    void setupMesh();
+    unsigned int VAO = 0, VBO = 0, EBO = 0;
+    unsigned int depthVAO = 0;
+    unsigned int indexCount = 0;
+    // 索引类型与索引数据在 EBO 中的起始字节（几何池或共享缓冲时非 0）
+    GLenum indexType = GL_UNSIGNED_INT;
+    size_t indexByteOffset = 0;
+    // 几何池中的区间；索引为网格内局部下标，绘制时加上 baseVertex
+    GeometryArena* arena = nullptr;
+    GeometryRange arenaRange;
+    std::shared_ptr<SharedBuffer> sharedBuffer;
+    bool packed = false;
+    VertexQuantization quantization;
+    // DrawClusters 每帧复用的提交列表
+    std::vector<GLsizei> clusterCounts;
+    std::vector<const void *> clusterOffsets;
+    std::vector<GLint> clusterBaseVertices;
+
+    size_t IndexSize() const;
+    // lod 对应的索引数与在 EBO 中的字节偏移
+    void LodRange(int lod, unsigned int &count, size_t &offset) const;
+    // 绑定材质并设置顶点格式相关的 uniform
+    void BindMaterial(Shader &shader, const Material *override);
+
+    void setupMesh(const Vertex *vertexData, size_t vertexCount, const void *indexData, size_t indexCount,
+                   GLenum indexType);
+    void setupPackedMesh(const PackedVertex *vertexData, size_t vertexCount, const void *indexData, size_t indexCount,
+                         GLenum indexType);
+    void setupArena(GeometryArena::Format format, const void *vertexData, size_t vertexCount, const void *indexData,
+                    size_t indexCount, GLenum indexType);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct MeshData;
+class ThreadPool;
+
+// MeshCache 类：模型的二进制缓存 (.meshbin)，与源文件放在同一目录
+// 文件内顶点/索引已按 Vertex / 索引类型布局，命中时直接内存映射后上传
+// [新增] 顶点数不超过 65536 时未压缩缓存只存 16 位索引
+// 也可以用 MeshCodec 压缩保存（体积通常为原来的 1/3 左右），命中时并行解码到内存
+// 失效条件：源文件大小变化，或修改时间变化且内容哈希也不同
+class MeshCache {
+public:
+    // 2: 索引与顶点经过 MeshOptimizer 重排
+    // 3: 增加 LOD 表
+    // 4: 增加网格簇表
+    // 5: 生成的法线改为面积与角度加权，并在硬边处拆分顶点
+    // 6: 文件头增加编码标志与数据字节数，支持 MeshCodec 压缩
+    // 7: 未压缩缓存按顶点数选择 16 / 32 位索引
+    // 8: 文件头增加包围球半径，命中时不再扫描顶点
+    static const uint32_t VERSION = 8;
+
+    static std::string CachePath(const std::string& sourcePath);
+
+    // 尝试读取缓存，命中时 out 的数据指针指向映射内存
+    static bool Load(const std::string& sourcePath, MeshData& out, ThreadPool& pool);
+
+    // 写入缓存（先写临时文件再重命名），sourceHash 为源文件内容哈希
+    // encode 为 true 时顶点与索引经 MeshCodec 压缩（三角形的顶点顺序可能被轮换）
+    static bool Save(const std::string& sourcePath, const MeshData& data, uint64_t sourceHash, bool encode = false);
+
+    // 内容哈希：按固定 4 MB 分块并行计算后再合并，结果与线程数无关
+    static uint64_t HashContent(const char* data, size_t size, ThreadPool& pool);
+};
+
+#endif
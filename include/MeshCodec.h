@@ -0,0 +1,43 @@
+#ifndef MESH_CODEC_H
+#define MESH_CODEC_H
+
+#include <cstddef>
+#include <vector>
+
+class ThreadPool;
+
+// MeshCodec 类：顶点/索引缓冲的无损压缩编码，用于磁盘上的网格（例如 .meshbin 缓存）
+// 顶点：每 256 个顶点一块，逐字节与前一顶点做差分并 zigzag，再按字节位置拆成字节平面，
+//       平面内每 16 个值按实际位宽存为 0 / 2 / 4 / 8 位。解码按 16 字节批量（SSE2 可用时）
+//       还原差分并转置回交错布局
+// 索引：边 FIFO + 顶点 FIFO。与最近三角形共享一条边的三角形只需 1 字节，
+//       新顶点按首次使用顺序递增时无需存储下标（输入应已经过 MeshOptimizer 重排）
+// 两种数据都切成互不依赖的段，解码可按段并行
+class MeshCodec {
+public:
+    // constexpr 静态成员隐式 inline：std::min 按引用取用时无需类外定义
+    static constexpr size_t VERTEX_BLOCK = 256;
+    // 每段的顶点数 / 三角形数
+    static constexpr size_t VERTEX_SEGMENT = 1 << 16;
+    static constexpr size_t INDEX_SEGMENT = 1 << 16;
+    // 顶点跨度上限（字节，须为 4 的倍数）
+    static constexpr size_t MAX_VERTEX_STRIDE = 256;
+
+    static std::vector<unsigned char> EncodeVertices(const void* vertices, size_t count, size_t stride);
+    // destination 须能容纳 count * stride 字节；数据损坏时返回 false
+    static bool DecodeVertices(void* destination, size_t count, size_t stride, const unsigned char* data, size_t size,
+                               ThreadPool* pool = nullptr);
+
+    // size 字节的编码数据最多能表示的顶点数 / 索引数，用于在分配前校验外部给出的计数
+    // 顶点：每个字节平面每 64 个顶点至少 1 字节组头；索引：每个三角形至少 1 字节
+    static size_t MaxVertexCount(size_t size, size_t stride) { return stride == 0 ? 0 : size / stride * 64 + 63; }
+    static size_t MaxIndexCount(size_t size) { return size * 3; }
+
+    // 三角形可能被轮换顶点顺序（绕序不变），三角形顺序保持不变
+    static std::vector<unsigned char> EncodeIndices(const unsigned int* indices, size_t count);
+    // 解出的下标不小于 vertexCount 时视为数据损坏，返回 false
+    static bool DecodeIndices(unsigned int* destination, size_t count, size_t vertexCount, const unsigned char* data,
+                              size_t size, ThreadPool* pool = nullptr);
+};
+
+#endif
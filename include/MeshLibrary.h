@@ -0,0 +1,39 @@
+#ifndef MESH_LIBRARY_H
+#define MESH_LIBRARY_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "Mesh.h"
+
+// [新增] 网格句柄：多个场景对象共享同一个 GPU 网格，最后一个句柄释放时删除
+typedef std::shared_ptr<Mesh> MeshHandle;
+
+// MeshLibrary 类：按键（基本体参数、文件路径等）登记网格，相同的键只创建和上传一次
+// 只保存弱引用，网格的生命周期由场景对象持有的句柄决定
+class MeshLibrary {
+public:
+    // 键对应的网格仍存活时直接返回，否则调用 create 创建并登记（create 返回空时不登记）
+    static MeshHandle Acquire(const std::string& key, const std::function<Mesh*()>& create);
+    // 只查找，不创建
+    static MeshHandle Find(const std::string& key);
+
+    static MeshHandle Cube();
+    static MeshHandle Sphere(int latitudeSegments, int longitudeSegments);
+
+    // 导入模型的键：同一路径、同一文件版本、同一顶点格式的导入共享网格
+    // version 由 FileVersion 在读取文件前取得，文件在磁盘上被修改后键随之改变，不再命中旧网格
+    static std::string FileKey(const std::string& path, bool packed, const std::string& version);
+    // 文件大小与修改时间；文件不存在时为空
+    static std::string FileVersion(const std::string& path);
+
+    // 存活的网格数（顺便清理已失效的条目）
+    static size_t LiveCount();
+
+private:
+    static std::unordered_map<std::string, std::weak_ptr<Mesh>> entries;
+};
+
+#endif
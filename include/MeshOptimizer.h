@@ -0,0 +1,49 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <cstddef>
+#include <vector>
+#include "Common.h"
+
+// 顶点缓存统计（FIFO 缓存模拟）
+// ACMR：每个三角形平均缓存未命中数（下限约 0.5，乱序时接近 3）
+// ATVR：未命中数 / 顶点数（理想值 1.0）
+struct VertexCacheStats {
+    size_t misses = 0;
+    float acmr = 0.0f;
+    float atvr = 0.0f;
+};
+
+// MeshOptimizer 类：上传前的索引/顶点重排，不改变网格形状
+// 1. OptimizeVertexCache：Tipsify 三角形重排，提高变换后顶点缓存命中率
+// 2. OptimizeOverdraw：把重排结果切成簇，按朝外程度排序，减少过度绘制
+// 3. OptimizeVertexFetch：按首次使用顺序重排顶点，提高顶点读取的局部性
+class MeshOptimizer {
+public:
+    // 模拟的缓存大小，与 Tipsify 的目标缓存大小一致
+    static const unsigned int CACHE_SIZE = 16;
+    // 切分软边界时允许的 ACMR 放大倍数
+    static constexpr float OVERDRAW_THRESHOLD = 1.05f;
+
+    static VertexCacheStats AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount,
+                                               unsigned int cacheSize = CACHE_SIZE);
+
+    // Tipsify：结果写入 destination（不能与 indices 重叠）
+    // clusters 非空时输出硬边界（每个簇第一个三角形的序号），供 OptimizeOverdraw 使用
+    static void OptimizeVertexCache(unsigned int* destination, const unsigned int* indices, size_t indexCount,
+                                    size_t vertexCount, unsigned int cacheSize = CACHE_SIZE,
+                                    std::vector<unsigned int>* clusters = nullptr);
+
+    // 在硬边界内再按局部 ACMR 切出软边界，然后按簇的朝外程度从大到小排序
+    static void OptimizeOverdraw(unsigned int* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount,
+                                 const std::vector<unsigned int>& clusters, float threshold = OVERDRAW_THRESHOLD,
+                                 unsigned int cacheSize = CACHE_SIZE);
+
+    // 原地重排 vertices 并改写 indices，未被引用的顶点被丢弃
+    static void OptimizeVertexFetch(std::vector<Vertex>& vertices, unsigned int* indices, size_t indexCount);
+
+    // 依次执行以上三步；verbose 时输出优化前后的 ACMR/ATVR
+    static void Optimize(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, bool verbose = true);
+};
+
+#endif
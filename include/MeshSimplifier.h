@@ -0,0 +1,35 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <cstddef>
+#include <vector>
+#include "Mesh.h"
+
+// MeshSimplifier 类：基于二次误差度量 (QEM) 的半边折叠简化
+// 只把顶点折叠到已有顶点上，简化结果仍引用原顶点数组，各级 LOD 共享同一个顶点缓冲
+// UV/法线接缝（同一位置有多个顶点）、开放边界和非流形边上的顶点被锁定，保证接缝不开裂
+class MeshSimplifier {
+public:
+    // LOD 链的最大级数（含 LOD0）
+    static const int MAX_LODS = 5;
+    // 每级的目标三角形比例
+    static constexpr float LOD_RATIO = 0.25f;
+    // 三角形数低于该值时不再生成更粗的 LOD
+    static const size_t MIN_LOD_TRIANGLES = 64;
+    // 允许的最大误差（相对包围盒对角线）
+    static constexpr float MAX_ERROR = 0.05f;
+
+    // 简化到不超过 targetIndexCount 个索引或误差达到 targetError 为止，结果写入 destination
+    // destination 至少能容纳 indexCount 个索引（可以与 indices 相同）；返回简化后的索引数
+    // resultError 非空时输出实际误差（相对包围盒对角线）
+    static size_t Simplify(unsigned int* destination, const unsigned int* indices, size_t indexCount,
+                           const Vertex* vertices, size_t vertexCount, size_t targetIndexCount,
+                           float targetError = MAX_ERROR, float* resultError = nullptr);
+
+    // 以 indices（LOD0）为起点逐级简化，各级索引依次追加到 indices 末尾
+    // 返回的 LOD 表中 lods[0] 为原网格；verbose 时输出每级三角形数与误差
+    static std::vector<MeshLod> BuildLodChain(std::vector<unsigned int>& indices, const Vertex* vertices,
+                                              size_t vertexCount, bool verbose = true);
+};
+
+#endif
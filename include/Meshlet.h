@@ -0,0 +1,40 @@
+#ifndef MESHLET_H
+#define MESHLET_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+#include "Common.h"
+
+// 网格簇 (meshlet)：索引缓冲中一段连续的三角形，附带剔除用的包围球与法线锥
+struct Meshlet
+{
+    unsigned int indexOffset;   // 在索引缓冲中的起始位置
+    unsigned int triangleCount;
+    unsigned int vertexCount;   // 引用的不同顶点数
+    glm::vec3 center;           // 包围球（局部空间）
+    float radius;
+    glm::vec3 coneAxis;         // 平均法线方向
+    float coneCutoff;           // 法线锥半角的正弦；1 表示法线太分散，不做背面剔除
+};
+
+// MeshletBuilder 类：按顺序扫描索引缓冲切分网格簇（不改变三角形顺序）
+// 输入应已经过顶点缓存优化，这样相邻三角形共享顶点，簇内顶点数接近上限
+class MeshletBuilder {
+public:
+    static const unsigned int MAX_VERTICES = 64;
+    static const unsigned int MAX_TRIANGLES = 124;
+
+    // indexBase：indices 在整个索引缓冲中的起始位置，写入 Meshlet::indexOffset
+    // verbose 时输出簇数、平均顶点数与三角形数
+    static std::vector<Meshlet> Build(const unsigned int* indices, size_t indexCount, const Vertex* vertices,
+                                      size_t vertexCount, unsigned int indexBase = 0, bool verbose = true);
+
+    // planes：局部空间的 6 个视锥平面（法线朝内，已归一化）；cameraLocal：局部空间的相机位置
+    static bool IsVisible(const Meshlet& meshlet, const glm::vec4* planes, const glm::vec3& cameraLocal);
+
+    // 从裁剪矩阵提取视锥平面；传入 projection * view * model 时得到的平面位于模型局部空间
+    static void ExtractFrustumPlanes(const glm::mat4& clip, glm::vec4* planes);
+};
+
+#endif
@@ -4,14 +4,90 @@
 #include <string>
 #include <vector>
 #include "Mesh.h"
+#include "MappedFile.h"
+
+struct ImportProgress;
+
+// [新增] 支持导入的模型格式
+enum class ModelFormat {
+    Obj,
+    Stl,
+    Ply,
+    Gltf // 多个图元，由 GltfLoader 读取，不经过 LoadMeshData
+};
+
+// [新增] 导入选项
+struct ImportOptions {
+    // 上传压缩顶点格式（16 字节/顶点），缓存中仍保存完整精度的 Vertex
+    bool packVertices = false;
+    // 缓存用 MeshCodec 压缩保存：文件更小，命中时需要解码（不再直接映射）
+    bool compressCache = false;
+};
+
+// 导入得到的 CPU 端网格数据
+// 解析路径的数据保存在 vertices / indices 中；缓存命中时保持 mapping，
+// 数据指针直接指向映射内存，上传时无需任何拷贝
+// [新增] 映射的缓存可能存放 16 位索引，此时 indexType 为 GL_UNSIGNED_SHORT，indices 为空
+struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    MappedFile mapping;
+
+    const Vertex* vertexData = nullptr;
+    size_t vertexCount = 0;
+    const void* indexData = nullptr;
+    size_t indexCount = 0;
+    GLenum indexType = GL_UNSIGNED_INT;
+
+    // 解析后计算一次（缓存命中时取自文件头），CreateMesh 直接交给 Mesh
+    BoundingVolume bounds;
+
+    // LOD 链：各级索引依次存放在同一个索引数组中（为空表示只有一级）
+    std::vector<MeshLod> lods;
+    // LOD0 的网格簇
+    std::vector<Meshlet> meshlets;
+
+    // packVertices 时由 vertexData 打包得到，CreateMesh 优先上传它
+    std::vector<PackedVertex> packedVertices;
+    VertexQuantization quantization;
+
+    // 数据指针指向自身的 vector
+    void UseOwnedArrays()
+    {
+        vertexData = vertices.data();
+        vertexCount = vertices.size();
+        indexData = indices.data();
+        indexCount = indices.size();
+        indexType = GL_UNSIGNED_INT;
+    }
+};
 
 // ModelLoader 类：负责从文件系统读取模型数据
-// 职责：[Part B] 负责实现具体的 OBJ 解析逻辑
+// 职责：[Part B] 负责实现具体的 OBJ 解析逻辑；STL / PLY 由 StlReader / PlyReader 读取
 class ModelLoader {
 public:
-    // 从路径加载 OBJ 文件，返回一个新的 Mesh 指针
+    // 单线程 OBJ 解析吞吐目标 (MB/s)，大文件低于此值时在日志中给出提示
+    static constexpr double TARGET_PARSE_MBPS = 250.0;
+
+    // 从路径加载模型文件（OBJ / STL / PLY），返回一个新的 Mesh 指针
     // 注意：调用者负责管理返回指针的内存（delete）
     static Mesh* LoadMesh(const std::string& path);
+
+    // [新增] 按文件头魔数判断格式（data 为空时只看扩展名），无法识别时按 OBJ 处理
+    static ModelFormat DetectFormat(const std::string& path, const char* data = nullptr, size_t size = 0);
+
+    // [新增] 读取 CPU 端数据：优先使用 .meshbin 缓存，未命中时解析源文件并写入缓存
+    // 不调用任何 GL 函数，可在后台线程执行；progress 非空时汇报进度并响应取消
+    static bool LoadMeshData(const std::string& path, MeshData& out, ImportProgress* progress = nullptr,
+                             const ImportOptions& options = ImportOptions());
+
+    // [新增] 用 CPU 端数据创建 GPU 网格（需在 GL 上下文线程调用）
+    static Mesh* CreateMesh(const MeshData& data);
+
+private:
+    // 缓存命中时直接映射，未命中时解析、优化并写入缓存
+    static bool LoadIndexedMesh(const std::string& path, MeshData& out, ImportProgress* progress,
+                                const ImportOptions& options);
 };
 
-#endif
\ No newline at end of file
+#endif
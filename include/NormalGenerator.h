@@ -0,0 +1,32 @@
+#ifndef NORMAL_GENERATOR_H
+#define NORMAL_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Common.h"
+
+class ThreadPool;
+
+// NormalGenerator 类：为缺少法线的索引网格生成平滑法线
+// 用于没有 vn 的 OBJ、STL（只有面法线）、不含法线的 PLY / glTF
+// 1. 按三角形区间并行统计每个位置的相邻角点，构建 位置 -> 角点 的邻接表
+// 2. 按位置区间并行：相邻面按折痕角分组，组内按 面积 × 角点夹角 加权平均面法线
+// 3. 同一顶点落在多个组时（硬边）拆分顶点，新顶点追加在末尾
+class NormalGenerator {
+public:
+    // 相邻面法线夹角超过该值（度）的边视为硬边，两侧使用各自的法线
+    static constexpr float DEFAULT_CREASE_ANGLE = 60.0f;
+    // 少于该三角形数时不拆分任务
+    static const size_t PARALLEL_MIN_TRIANGLES = 1 << 16;
+
+    // creaseAngle >= 180 时不拆分顶点（完全平滑）
+    // positionIds：每个顶点的位置编号，编号相同的顶点（例如 UV 接缝两侧）之间同样平滑；为空时按顶点下标
+    // generate：只为标记非 0 的顶点生成法线，其余顶点及其角点保持不变；为空时全部生成
+    // 返回拆分新增的顶点数；结果与线程数无关
+    static size_t Generate(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, ThreadPool& pool,
+                           float creaseAngle = DEFAULT_CREASE_ANGLE, const std::vector<uint32_t>* positionIds = nullptr,
+                           const std::vector<unsigned char>* generate = nullptr);
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef OBJ_PARSER_H
+#define OBJ_PARSER_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+class ThreadPool;
+struct ImportProgress;
+
+// OBJ 面的一个角点：位置 / 纹理坐标 / 法线的下标（0 起始，-1 表示缺省）
+struct ObjIndex {
+    int v;
+    int vt;
+    int vn;
+};
+
+// OBJ 原始数据：属性数组 + 三角化后的角点（每 3 个构成一个三角形）
+struct ObjData {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> texCoords;
+    std::vector<glm::vec3> normals;
+    std::vector<ObjIndex> corners;
+};
+
+// ObjParser 类：直接在内存映射的文本上解析 OBJ
+// 不使用 iostream，不按 token 分配内存；多边形按扇形三角化
+class ObjParser {
+public:
+    // 小于该字节数的文件不分块，直接串行解析
+    static const size_t PARALLEL_MIN_BYTES = 4 * 1024 * 1024;
+
+    // 串行解析 [begin, end)，结果写入 out（out 须为空）
+    static void Parse(const char* begin, const char* end, ObjData& out);
+
+    // 在行边界处切分为多个块并行解析，合并时修正负下标的偏移
+    // 结果与 Parse 完全一致；返回实际使用的块数
+    // progress 非空时按已解析字节数报告进度，取消后尽快返回（out 内容不完整）
+    static size_t ParseParallel(const char* begin, const char* end, ObjData& out, ThreadPool& pool,
+                                ImportProgress* progress = nullptr);
+
+    // 解析文件中的一段（流式导入按窗口调用）：out 只接收本段的数据，
+    // 负下标按给定的全局已读取数量解析，输出的角点下标均为全局下标
+    static void ParseSection(const char* begin, const char* end, ObjData& out,
+                             size_t positionBase, size_t texCoordBase, size_t normalBase);
+
+    // 查找下一个 '\n'（SSE2 可用时按 16 字节批量比较），找不到返回 end
+    static const char* FindNewline(const char* p, const char* end);
+};
+
+#endif
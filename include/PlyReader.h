@@ -0,0 +1,25 @@
+#ifndef PLY_READER_H
+#define PLY_READER_H
+
+#include <cstddef>
+#include <vector>
+#include "Common.h"
+
+struct ImportProgress;
+
+// PlyReader 类：在内存映射的数据上读取 PLY（ascii / binary_little_endian / binary_big_endian）
+// 读取 vertex 元素的 x y z、nx ny nz、u v（或 s t / texture_u texture_v），
+// face 元素的 vertex_indices（vertex_index）列表，多边形按扇形三角化；其余元素与属性跳过
+// PLY 本身就是索引网格，顶点直接写入输出数组，不做去重
+class PlyReader {
+public:
+    // 文件以 "ply" 行开头
+    static bool IsPly(const char* data, size_t size);
+
+    // vertices / indices 须为空；返回 false 表示文件头或数据损坏、没有三角形或已取消
+    // 小端 float 顶点直接按偏移拷贝，布局与 Vertex 完全一致时整块拷贝
+    static bool Read(const char* data, size_t size, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
+                     ImportProgress* progress = nullptr);
+};
+
+#endif
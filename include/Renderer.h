@@ -35,13 +35,48 @@ namespace PartC
         static const unsigned int SHADOW_WIDTH = 1024, SHADOW_HEIGHT = 1024;
         static Shader *depthShader;
         static glm::mat4 lightSpaceMatrix;
+        static glm::vec3 shadowCenter;
+        static float shadowRadius;
 
         static void InitShadowMap();
+        // [新增] 阴影正交投影覆盖的世界空间包围球（每帧由场景包围体设置，默认为原点附近半径 10）
+        static void FitShadowBounds(const glm::vec3 &center, float radius);
         static void BeginShadowMap();
         static void EndShadowMap(int scrWidth, int scrHeight);
 
-        // [接口] 统一渲染入口
-        static void RenderMesh(Mesh *mesh, Shader &shader, const glm::mat4 &modelMatrix);
+        // [新增] LOD 选择：允许的屏幕空间误差（像素）与当前视点
+        static float lodErrorPixels;
+        static glm::vec3 lodViewPosition;
+        static float lodPixelsPerUnit; // 距离为 1 时每单位长度对应的像素数
+        // [新增] 逐簇剔除开关与本帧的 projection * view
+        static bool clusterCulling;
+        static glm::mat4 viewProjection;
+        // [新增] 本帧 RenderMesh 的统计：提交的三角形数、可见簇数 / 参与剔除的簇数
+        static size_t trianglesDrawn;
+        static size_t clustersDrawn;
+        static size_t clustersTested;
+        // [新增] 实例化：共享网格的对象合并绘制；本帧实例化绘制次数与实例数（含阴影）
+        static bool instancing;
+        static size_t instancedDraws;
+        static size_t instancesDrawn;
+        // [新增] 多重间接绘制（需要 GL 4.3 或 ARB_multi_draw_indirect）；本帧间接提交次数与命令数
+        static bool multiDrawIndirect;
+        static size_t indirectSubmits;
+        static size_t indirectCommands;
+        // [新增] 本帧的世界空间视锥平面（BeginFrame 中提取）
+        static glm::vec4 frustumPlanes[6];
+
+        // 每帧开始时设置视点与视锥，同时清零统计（含材质的纹理绑定记录）
+        static void BeginFrame(const glm::vec3 &viewPos, const glm::mat4 &viewProj, float fovYRadians, int viewportHeight);
+        // 按包围盒对角线的屏幕投影长度选择误差不超过 lodErrorPixels 的最粗 LOD
+        static int SelectLod(const Mesh *mesh, const glm::mat4 &modelMatrix);
+        // [新增] 网格包围盒的外接球是否与视锥相交
+        static bool IsVisible(const Mesh *mesh, const glm::mat4 &modelMatrix);
+
+        // [接口] 统一渲染入口（自动选择 LOD；LOD0 且有网格簇时逐簇剔除）
+        // material 非空时代替网格自带的材质
+        static void RenderMesh(Mesh *mesh, Shader &shader, const glm::mat4 &modelMatrix,
+                               const Material *material = nullptr);
 
         // [接口] 设置光照参数
         static void SetupLights(Shader &shader, const glm::vec3 &camPos);
@@ -5,11 +5,16 @@
 #include <string>
 #include <glm/glm.hpp>
 #include "Mesh.h"
+#include "MeshLibrary.h"
 #include "Shader.h"
 
+class ChunkedMesh;
+class DynamicMesh;
+
 struct SceneObject {
     std::string name;
-    Mesh* mesh;
+    // [新增] 共享网格句柄，多个对象可引用同一个网格
+    MeshHandle mesh;
     glm::vec3 position;
     glm::vec3 rotation;
     glm::vec3 scale;
@@ -19,9 +24,20 @@ struct SceneObject {
     std::string texturePath; 
     // [新增] 纹理ID (如果加载成功)
     unsigned int textureId = 0; 
+    // [新增] 对象自己的纹理（网格共享，纹理按对象设置）；为空时使用网格自带的纹理
+    std::vector<Texture> textures;
+    // [新增] 由 textures 解析的材质，修改 textures 后需重新构造
+    Material material;
+    // [新增] 流式导入的分块网格（非空时 mesh 为空，按相机位置分页载入）
+    ChunkedMesh* chunkedMesh = nullptr;
+    // [新增] 每帧由 CPU 改写顶点的动态网格（非空时 mesh 为空）
+    DynamicMesh* dynamicMesh = nullptr;
+
+    SceneObject(std::string n, MeshHandle m) 
+        : name(n), mesh(std::move(m)), position(0.0f), rotation(0.0f), scale(1.0f), color(1.0f), texturePath("") {}
 
-    SceneObject(std::string n, Mesh* m) 
-        : name(n), mesh(m), position(0.0f), rotation(0.0f), scale(1.0f), color(1.0f), texturePath("") {}
+    // [新增] 模型矩阵 T * Rx * Ry * Rz * S（渲染、拾取与 glTF 变换分解共用这一顺序）
+    glm::mat4 ModelMatrix() const;
 };
 
 class SceneContext {
@@ -33,6 +49,8 @@ public:
     ~SceneContext();
 
     void AddObject(SceneObject* obj);
+    // 对象材质，对象没有纹理时返回 nullptr（使用网格自带材质）
+    static const Material* MaterialOf(const SceneObject* obj);
     void DrawAll(Shader& shader);
 };
 
@@ -13,6 +13,29 @@ class Shader
 public:
     unsigned int ID;
 
+    // [新增] 材质相关 uniform 的状态（由 Material::Bind 维护）：位置首次绑定时解析，值变化时才上传
+    struct MaterialUniforms
+    {
+        bool resolved = false;
+        GLint useTexture = -1;
+        int useTextureValue = -1;
+    };
+    MaterialUniforms materialUniforms;
+
+    // [新增] 顶点格式 uniform 的状态（由 Mesh::SetQuantization 维护），同样按位置上传、值不变时跳过
+    struct QuantizationUniforms
+    {
+        bool resolved = false;
+        GLint quantized = -1;
+        GLint offset = -1;
+        GLint scale = -1;
+        bool uploaded = false; // 以下的值是否已上传过
+        bool quantizedValue = false;
+        glm::vec3 offsetValue = glm::vec3(0.0f);
+        glm::vec3 scaleValue = glm::vec3(1.0f);
+    };
+    QuantizationUniforms quantizationUniforms;
+
     // 构造函数读取并构建着色器
     Shader(const char *vertexPath, const char *fragmentPath);
 
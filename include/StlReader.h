@@ -0,0 +1,27 @@
+#ifndef STL_READER_H
+#define STL_READER_H
+
+#include <cstddef>
+#include <vector>
+#include "Common.h"
+
+struct ImportProgress;
+
+// StlReader 类：在内存映射的数据上读取 STL（二进制与 ASCII）
+// STL 的三角形互不共享顶点，读取时按位置坐标的位模式焊接，
+// 输出紧凑的索引网格，法线按焊接后的拓扑重新生成（平滑，硬边处拆分顶点）
+class StlReader {
+public:
+    // 二进制 STL：80 字节文件头 + uint32 三角形数 + 每个三角形 50 字节
+    static const size_t HEADER_BYTES = 84;
+    static const size_t TRIANGLE_BYTES = 50;
+
+    // 文件大小与头部声明的三角形数吻合即视为二进制（不少二进制文件头同样以 "solid" 开头）
+    static bool IsBinary(const char* data, size_t size);
+
+    // vertices / indices 须为空；返回 false 表示数据损坏、没有三角形或已取消
+    static bool Read(const char* data, size_t size, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
+                     ImportProgress* progress = nullptr);
+};
+
+#endif
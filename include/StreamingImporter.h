@@ -0,0 +1,76 @@
+#ifndef STREAMING_IMPORTER_H
+#define STREAMING_IMPORTER_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Mesh.h"
+
+struct ImportProgress;
+
+// 流式导入参数
+struct StreamingOptions {
+    // 导入过程的内存预算（字节），读取窗口、缓存页、分块大小均按此推导
+    size_t memoryBudget = 512u * 1024 * 1024;
+    // 每个输出块的三角形上限（会再按内存预算收紧）
+    size_t chunkTriangles = 1u << 20;
+};
+
+// ChunkedMesh 类：按空间区域切分、存放在磁盘上的网格
+// 每个块是一个独立文件，渲染时只把与关注区域相交的块载入显存
+class ChunkedMesh {
+public:
+    struct Chunk {
+        std::string path;
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+        size_t vertexCount;
+        size_t indexCount;
+        Mesh* mesh = nullptr;   // 常驻时非空
+    };
+
+    std::vector<Chunk> chunks;
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+
+    ChunkedMesh() = default;
+    ~ChunkedMesh();
+    ChunkedMesh(const ChunkedMesh&) = delete;
+    ChunkedMesh& operator=(const ChunkedMesh&) = delete;
+
+    // 读取导入时生成的清单文件
+    static ChunkedMesh* LoadManifest(const std::string& manifestPath);
+
+    // 载入与球形区域相交的块（由近到远，直到常驻数据达到 residentBudget 字节），卸载其余
+    // 每次调用最多新载入 maxLoads 个块，避免单帧卡顿（需在 GL 线程调用）
+    void UpdateResidency(const glm::vec3& center, float radius, size_t residentBudget, int maxLoads = 2);
+
+    void Draw(Shader& shader);
+    // [新增] 深度渲染：只读取各块的位置流
+    void DrawDepth(Shader& shader);
+
+    size_t ResidentBytes() const;
+    size_t ResidentCount() const;
+
+private:
+    bool PageIn(Chunk& chunk);
+    void PageOut(Chunk& chunk);
+};
+
+// StreamingImporter 类：内存占用受限的 OBJ 流式导入
+// 1. 按固定窗口读取文件，把 v/vt/vn/f 分别溢写到临时文件，同时统计包围盒
+// 2. 顺序读取角点，按三角形重心分配到空间网格单元，单元数据溢写到单元文件
+// 3. 逐单元按固定三角形数切块、去重，写出块文件与清单
+// 所有阶段的内存只与 memoryBudget 有关，与输入文件大小无关
+class StreamingImporter {
+public:
+    // 输出目录：<source>.chunks/，源文件未变化时直接复用已有的清单
+    static std::string OutputDirectory(const std::string& sourcePath);
+
+    // 不调用 GL 函数，可在后台线程执行；返回的网格尚无常驻块
+    static ChunkedMesh* Import(const std::string& path, const StreamingOptions& options,
+                               ImportProgress* progress = nullptr);
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ThreadPool 类：常驻工作线程池，供模型导入等 CPU 密集任务并行使用
+class ThreadPool {
+public:
+    // 进程共享的线程池，线程数 = 硬件线程数 - 1（调用线程也参与计算）
+    static ThreadPool& Global();
+
+    explicit ThreadPool(unsigned int workerCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 参与计算的总线程数（工作线程 + 调用线程）
+    unsigned int Concurrency() const { return static_cast<unsigned int>(workers.size()) + 1; }
+
+    // 并行执行 task(0..count-1)，全部完成后返回
+    // 调用线程同样领取任务，因此在工作线程繁忙时也不会死锁
+    void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    bool stopping = false;
+
+    void WorkerLoop();
+};
+
+#endif
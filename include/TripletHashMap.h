@@ -0,0 +1,89 @@
+#ifndef TRIPLET_HASH_MAP_H
+#define TRIPLET_HASH_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// TripletHashMap 类：以三个 32 位整数为键、32 位整数为值的开放寻址哈希表
+// 线性探测 + 2 的幂容量，所有槽位放在一块连续内存中，插入时不逐个分配
+// 用于顶点去重：OBJ 的 (v, vt, vn) 角点、STL 的位置坐标位模式等
+class TripletHashMap {
+public:
+    // expectedCount：预计的不同键数量，仅用于确定初始容量
+    explicit TripletHashMap(size_t expectedCount)
+    {
+        size_t capacity = 16;
+        while (capacity < expectedCount + expectedCount / 2)
+            capacity <<= 1;
+        slots.assign(capacity, Slot{0, 0, 0, EMPTY});
+        mask = capacity - 1;
+    }
+
+    // 若键已存在返回已有值，否则插入 value 并返回 value
+    uint32_t FindOrInsert(uint32_t a, uint32_t b, uint32_t c, uint32_t value)
+    {
+        // 负载因子超过 0.7 时扩容
+        if ((count + 1) * 10 > slots.size() * 7)
+            Grow();
+
+        size_t i = Hash(a, b, c) & mask;
+        while (true)
+        {
+            Slot &slot = slots[i];
+            if (slot.value == EMPTY)
+            {
+                slot = Slot{a, b, c, value};
+                count++;
+                return value;
+            }
+            if (slot.a == a && slot.b == b && slot.c == c)
+                return slot.value;
+            i = (i + 1) & mask;
+        }
+    }
+
+    size_t Size() const { return count; }
+
+private:
+    struct Slot {
+        uint32_t a, b, c;
+        uint32_t value;
+    };
+
+    static const uint32_t EMPTY = 0xFFFFFFFFu;
+
+    std::vector<Slot> slots;
+    size_t mask = 0;
+    size_t count = 0;
+
+    static size_t Hash(uint32_t a, uint32_t b, uint32_t c)
+    {
+        uint32_t h = a * 0x9E3779B1u;
+        h ^= b * 0x85EBCA77u + (h << 6) + (h >> 2);
+        h ^= c * 0xC2B2AE3Du + (h << 6) + (h >> 2);
+        h ^= h >> 15;
+        h *= 0x2C1B3C6Du;
+        h ^= h >> 12;
+        return h;
+    }
+
+    void Grow()
+    {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.assign(old.size() * 2, Slot{0, 0, 0, EMPTY});
+        mask = slots.size() - 1;
+        for (const Slot &slot : old)
+        {
+            if (slot.value == EMPTY)
+                continue;
+            size_t i = Hash(slot.a, slot.b, slot.c) & mask;
+            while (slots[i].value != EMPTY)
+                i = (i + 1) & mask;
+            slots[i] = slot;
+        }
+    }
+};
+
+#endif
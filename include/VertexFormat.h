@@ -0,0 +1,163 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <glad/glad.h>
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include "Common.h"
+
+// [新增] 一个顶点属性：对应一次 glVertexAttribPointer
+struct VertexAttribute
+{
+    GLuint location;
+    GLint components;
+    GLenum type;
+    GLboolean normalized;
+    size_t offset;    // 相对结构体起点的字节偏移
+    const char *name; // 着色器中的变量名；矩阵的后续列为 nullptr（不单独校验）
+};
+
+// [新增] VertexLayout<T>：顶点结构体 T 的编译期属性表，每种布局提供一个特化：
+//   static constexpr std::array<VertexAttribute, N> attributes;
+//   static constexpr GLuint divisor; // 0 = 逐顶点，1 = 逐实例
+// 新增布局只需写一个特化并在其后 static_assert(VertexFormat::IsValid<T>())
+template <typename T>
+struct VertexLayout;
+
+// VertexFormat 类：由 VertexLayout 生成 VAO 属性设置，并在编译期检查偏移与位置
+class VertexFormat
+{
+public:
+    static constexpr size_t ComponentSize(GLenum type)
+    {
+        return type == GL_FLOAT || type == GL_INT || type == GL_UNSIGNED_INT ? 4
+               : type == GL_SHORT || type == GL_UNSIGNED_SHORT || type == GL_HALF_FLOAT ? 2
+               : type == GL_BYTE || type == GL_UNSIGNED_BYTE ? 1
+                                                               : 0;
+    }
+
+    // 每个属性都落在结构体内、互不重叠，且属性位置不重复
+    template <typename T>
+    static constexpr bool IsValid()
+    {
+        constexpr auto &attributes = VertexLayout<T>::attributes;
+        for (size_t i = 0; i < attributes.size(); i++)
+        {
+            const size_t size = ComponentSize(attributes[i].type) * attributes[i].components;
+            if (size == 0 || attributes[i].components < 1 || attributes[i].components > 4)
+                return false;
+            if (attributes[i].offset + size > sizeof(T))
+                return false;
+            for (size_t j = i + 1; j < attributes.size(); j++)
+            {
+                const size_t otherSize = ComponentSize(attributes[j].type) * attributes[j].components;
+                if (attributes[i].location == attributes[j].location)
+                    return false;
+                if (attributes[i].offset < attributes[j].offset + otherSize &&
+                    attributes[j].offset < attributes[i].offset + size)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    // 在当前绑定的 VAO 上启用 T 的全部属性，数据来自当前 GL_ARRAY_BUFFER 的 baseOffset 处
+    template <typename T>
+    static void Apply(size_t baseOffset = 0)
+    {
+        static_assert(IsValid<T>(), "invalid vertex layout");
+        for (const VertexAttribute &attribute : VertexLayout<T>::attributes)
+        {
+            glEnableVertexAttribArray(attribute.location);
+            glVertexAttribPointer(attribute.location, attribute.components, attribute.type, attribute.normalized,
+                                  sizeof(T), (void *)(baseOffset + attribute.offset));
+            if (VertexLayout<T>::divisor != 0)
+                glVertexAttribDivisor(attribute.location, VertexLayout<T>::divisor);
+        }
+    }
+
+    // 关闭 T 的全部属性并恢复逐顶点步进
+    template <typename T>
+    static void Disable()
+    {
+        for (const VertexAttribute &attribute : VertexLayout<T>::attributes)
+        {
+            glDisableVertexAttribArray(attribute.location);
+            if (VertexLayout<T>::divisor != 0)
+                glVertexAttribDivisor(attribute.location, 0);
+        }
+    }
+
+    // 着色器链接后调用：着色器声明的属性位置必须与布局一致（未使用的属性会被优化掉，跳过）
+    template <typename T>
+    static bool CheckProgram(GLuint program, const char *label)
+    {
+        bool matches = true;
+        for (const VertexAttribute &attribute : VertexLayout<T>::attributes)
+        {
+            if (!attribute.name)
+                continue;
+            GLint location = glGetAttribLocation(program, attribute.name);
+            if (location >= 0 && static_cast<GLuint>(location) != attribute.location)
+            {
+                std::cerr << "[VertexFormat] " << label << ": attribute " << attribute.name << " at location "
+                          << location << ", layout expects " << attribute.location << std::endl;
+                matches = false;
+            }
+        }
+        return matches;
+    }
+};
+
+// 标准顶点：位置、法线、纹理坐标均为 float
+template <>
+struct VertexLayout<Vertex>
+{
+    static constexpr GLuint divisor = 0;
+    static constexpr std::array<VertexAttribute, 3> attributes = {{
+        {0, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, Position), "aPos"},
+        {1, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, Normal), "aNormal"},
+        {2, 2, GL_FLOAT, GL_FALSE, offsetof(Vertex, TexCoords), "aTexCoords"},
+    }};
+};
+static_assert(VertexFormat::IsValid<Vertex>(), "Vertex layout");
+
+// 压缩顶点：位置 16 位无符号归一化（着色器中乘 quantScale 加 quantOffset），
+// 法线为八面体编码的 16 位有符号归一化，纹理坐标为半精度浮点
+template <>
+struct VertexLayout<PackedVertex>
+{
+    static constexpr GLuint divisor = 0;
+    static constexpr std::array<VertexAttribute, 3> attributes = {{
+        {0, 3, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(PackedVertex, Position), "aPos"},
+        {1, 2, GL_SHORT, GL_TRUE, offsetof(PackedVertex, Normal), "aNormal"},
+        {2, 2, GL_HALF_FLOAT, GL_FALSE, offsetof(PackedVertex, TexCoords), "aTexCoords"},
+    }};
+};
+static_assert(VertexFormat::IsValid<PackedVertex>(), "PackedVertex layout");
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must stay 16 bytes");
+
+// [新增] 深度位置流：只有位置一个属性
+template <>
+struct VertexLayout<PositionVertex>
+{
+    static constexpr GLuint divisor = 0;
+    static constexpr std::array<VertexAttribute, 1> attributes = {{
+        {0, 3, GL_FLOAT, GL_FALSE, offsetof(PositionVertex, Position), "aPos"},
+    }};
+};
+static_assert(VertexFormat::IsValid<PositionVertex>(), "PositionVertex layout");
+static_assert(sizeof(PositionVertex) == 12, "PositionVertex must be tightly packed");
+
+template <>
+struct VertexLayout<PackedPosition>
+{
+    static constexpr GLuint divisor = 0;
+    static constexpr std::array<VertexAttribute, 1> attributes = {{
+        {0, 3, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(PackedPosition, Position), "aPos"},
+    }};
+};
+static_assert(VertexFormat::IsValid<PackedPosition>(), "PackedPosition layout");
+
+#endif
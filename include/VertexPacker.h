@@ -0,0 +1,47 @@
+#ifndef VERTEX_PACKER_H
+#define VERTEX_PACKER_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Common.h"
+
+// 压缩顶点的位置反量化参数：Position = offset + packed / 65535 * scale
+struct VertexQuantization
+{
+    glm::vec3 offset = glm::vec3(0.0f);
+    glm::vec3 scale = glm::vec3(1.0f);
+};
+
+// 打包后逐顶点解码得到的最大误差
+struct PackError
+{
+    float position = 0.0f;      // 位置（模型单位）
+    float normalDegrees = 0.0f; // 法线夹角（度）
+    float texCoord = 0.0f;      // 纹理坐标（各分量绝对误差）
+};
+
+// VertexPacker 类：Vertex (32 字节) 与 PackedVertex (16 字节) 之间的转换
+// 解码与 vertex.glsl / shadow_depth.vert 中的实现一致
+class VertexPacker {
+public:
+    // 按 vertices 的包围盒量化位置，返回反量化参数
+    static VertexQuantization Pack(const Vertex* vertices, size_t count, std::vector<PackedVertex>& out);
+
+    // CPU 端解码（用于校验量化误差）
+    static Vertex Unpack(const PackedVertex& packed, const VertexQuantization& quantization);
+    // 用 Unpack 解码 packed 并与原顶点比较
+    static PackError MeasureError(const Vertex* vertices, const PackedVertex* packed, size_t count,
+                                  const VertexQuantization& quantization);
+
+    // 单位向量 <-> 八面体编码（两个分量均在 [-1, 1]）
+    static glm::vec2 OctEncode(const glm::vec3& n);
+    static glm::vec3 OctDecode(const glm::vec2& e);
+
+    // IEEE 754 半精度转换（就近舍入，超出范围时饱和）
+    static uint16_t FloatToHalf(float value);
+    static float HalfToFloat(uint16_t half);
+};
+
+#endif
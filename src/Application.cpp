@@ -1,6 +1,9 @@
 #include "Application.h"
 #include <iostream>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <vector>
 
 #include "imgui.h"
@@ -10,9 +13,24 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "ModelLoader.h"
-#include "GeometryUtils.h"
+#include "ImportTask.h"
+#include "GltfLoader.h"
+#include "StreamingImporter.h"
+#include "MeshLibrary.h"
 #include "Renderer.h"
+#include "GeometryArena.h"
+#include "InstanceBatcher.h"
+#include "GLExtensions.h"
+#include "DynamicMesh.h"
+#include "GeometryUtils.h"
 #include "Texture.h"
+#include "VertexFormat.h"
+
+namespace
+{
+    // [新增] 波浪演示网格的格子数（每边）
+    const int WAVE_RESOLUTION = 128;
+}
 
 Application::Application(const std::string &title, int width, int height)
     : appTitle(title), scrWidth(width), scrHeight(height),
@@ -26,8 +44,15 @@ Application::Application(const std::string &title, int width, int height)
 
 Application::~Application()
 {
+    // 先停止后台导入，再销毁场景
+    if (importTask)
+        delete importTask;
     if (scene)
         delete scene;
+    if (instanceBatcher)
+        delete instanceBatcher;
+    // 所有 Mesh 已释放，删除几何池的 GL 缓冲
+    GeometryArena::DestroyAll();
     if (camera)
         delete camera;
     if (mainShader)
@@ -42,14 +67,22 @@ Application::~Application()
 bool Application::InitGLFW()
 {
     glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 #ifdef __APPLE__
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
 
-    window = glfwCreateWindow(scrWidth, scrHeight, appTitle.c_str(), NULL, NULL);
+    // [新增] 优先创建 4.3 上下文（multi-draw indirect），不支持时回退到 3.3
+    const int versions[][2] = {{4, 3}, {3, 3}};
+    window = nullptr;
+    for (const auto &version : versions)
+    {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, version[0]);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, version[1]);
+        window = glfwCreateWindow(scrWidth, scrHeight, appTitle.c_str(), NULL, NULL);
+        if (window)
+            break;
+    }
     if (!window)
     {
         std::cerr << "Failed to create GLFW window" << std::endl;
@@ -68,6 +101,7 @@ bool Application::InitGLFW()
         std::cerr << "Failed to initialize GLAD" << std::endl;
         return false;
     }
+    GLExtensions::Load((GLADloadproc)glfwGetProcAddress);
     glEnable(GL_DEPTH_TEST);
 
     // [Part C] Init Shadow Map
@@ -97,18 +131,21 @@ void Application::InitScene()
 {
     camera = new Camera(glm::vec3(0.0f, 4.0f, 8.0f));
     scene = new SceneContext();
+    instanceBatcher = new PartC::InstanceBatcher();
     mainShader = new Shader("assets/shaders/vertex.glsl", "assets/shaders/fragment.glsl");
+    // [新增] 着色器中的属性位置须与各顶点布局一致
+    VertexFormat::CheckProgram<Vertex>(mainShader->ID, "main");
+    VertexFormat::CheckProgram<PartC::InstanceData>(mainShader->ID, "main");
 
     // 地面
-    Mesh *floorMesh = GeometryUtils::CreateCube();
-    SceneObject *floorObj = new SceneObject("Ground Plane", floorMesh);
+    SceneObject *floorObj = new SceneObject("Ground Plane", MeshLibrary::Cube());
     floorObj->scale = glm::vec3(20.0f, 0.01f, 20.0f);
     floorObj->position = glm::vec3(0.0f, -0.01f, 0.0f);
     floorObj->color = glm::vec3(0.25f, 0.25f, 0.25f);
     scene->AddObject(floorObj);
 
-    // 默认测试物体
-    Mesh *cubeMesh = GeometryUtils::CreateCube();
+    // 默认测试物体（与地面共用同一个立方体网格，纹理设置在对象上）
+    SceneObject *cubeObj = new SceneObject("Cube", MeshLibrary::Cube());
 
     // [Part C Test] Manually create a checkerboard texture to verify rendering pipeline
     unsigned int texID;
@@ -147,10 +184,9 @@ void Application::InitScene()
     specularMap.type = "specular";
     specularMap.path = "generated_checkerboard";
 
-    cubeMesh->textures.push_back(diffuseMap);
-    cubeMesh->textures.push_back(specularMap);
-
-    SceneObject *cubeObj = new SceneObject("Cube", cubeMesh);
+    cubeObj->textures.push_back(diffuseMap);
+    cubeObj->textures.push_back(specularMap);
+    cubeObj->material = Material(cubeObj->textures);
     cubeObj->position = glm::vec3(0.0f, 0.5f, 0.0f);
     cubeObj->color = glm::vec3(1.0f, 1.0f, 1.0f);
     scene->AddObject(cubeObj);
@@ -167,7 +203,9 @@ void Application::DeleteSelectedObject()
     {
         if (*it == scene->selectedObject)
         {
-            delete (*it)->mesh;
+            // 网格为共享句柄，其他对象仍在使用时不会释放
+            delete (*it)->chunkedMesh;
+            delete (*it)->dynamicMesh;
             delete *it;
             it = objs.erase(it);
             scene->selectedObject = nullptr;
@@ -180,6 +218,53 @@ void Application::DeleteSelectedObject()
     }
 }
 
+// 后台导入完成后，在主线程（GL 上下文线程）创建 GPU 网格
+void Application::PollImportTask()
+{
+    if (!importTask || !importTask->IsFinished())
+        return;
+
+    if (importTask->Succeeded() && importTask->IsStreaming())
+    {
+        // 分块网格此时没有常驻块，由 RenderScene 按相机位置分页载入
+        SceneObject *newObj = new SceneObject("Streamed Model", nullptr);
+        newObj->chunkedMesh = importTask->TakeChunkedMesh();
+        scene->AddObject(newObj);
+    }
+    else if (importTask->Succeeded() && importTask->IsGltf())
+    {
+        // 每个图元一个对象，direct 图元共用同一个 GPU 缓冲
+        GltfModel &model = importTask->GltfResult();
+        std::vector<Mesh *> meshes = GltfLoader::CreateMeshes(model);
+        for (size_t i = 0; i < meshes.size(); i++)
+        {
+            const GltfPrimitive &primitive = model.primitives[i];
+            SceneObject *newObj = new SceneObject(primitive.name, MeshHandle(meshes[i]));
+            GltfLoader::DecomposeTransform(primitive.transform, newObj->position, newObj->rotation, newObj->scale);
+            newObj->color = primitive.color;
+            scene->AddObject(newObj);
+        }
+    }
+    else if (importTask->Succeeded())
+    {
+        // 按路径与导入开始时的文件版本登记，之后再导入未修改的同一文件时直接共享该网格
+        MeshData &data = importTask->Result();
+        MeshHandle imported = MeshLibrary::Acquire(MeshLibrary::FileKey(importTask->Path(), !data.packedVertices.empty(),
+                                                                        importVersion),
+                                                   [&]()
+                                                   { return ModelLoader::CreateMesh(data); });
+        SceneObject *newObj = new SceneObject("Imported Model", imported);
+        scene->AddObject(newObj);
+    }
+    else if (!importTask->IsCancelled())
+    {
+        std::cout << "Failed to load model from " << importTask->Path() << std::endl;
+    }
+
+    delete importTask;
+    importTask = nullptr;
+}
+
 void Application::Run()
 {
     if (!InitGLFW())
@@ -195,6 +280,7 @@ void Application::Run()
         lastFrame = currentFrame;
 
         ProcessInput();
+        PollImportTask();
 
         glClearColor(0.12f, 0.12f, 0.12f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -269,6 +355,17 @@ bool Application::IntersectRayPlane(const glm::vec3 &rayOrigin, const glm::vec3
     return false;
 }
 
+BoundingVolume Application::ObjectBounds(const SceneObject *obj)
+{
+    if (obj->mesh)
+        return obj->mesh->bounds;
+    if (obj->chunkedMesh)
+        return BoundingVolume::FromBox(obj->chunkedMesh->boundsMin, obj->chunkedMesh->boundsMax);
+    if (obj->dynamicMesh)
+        return obj->dynamicMesh->bounds;
+    return BoundingVolume::FromBox(glm::vec3(-0.5f), glm::vec3(0.5f));
+}
+
 bool Application::IntersectRayAABB(const glm::vec3 &rayOrigin, const glm::vec3 &rayDir,
                                    const glm::vec3 &boxMin, const glm::vec3 &boxMax,
                                    float &t)
@@ -305,19 +402,20 @@ void Application::SelectObjectFromMouse(double xpos, double ypos)
 
     for (auto obj : scene->objects)
     {
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, obj->position);
-        model = glm::rotate(model, glm::radians(obj->rotation.y), glm::vec3(0, 1, 0));
-        model = glm::rotate(model, glm::radians(obj->rotation.x), glm::vec3(1, 0, 0));
-        model = glm::rotate(model, glm::radians(obj->rotation.z), glm::vec3(0, 0, 1));
-        model = glm::scale(model, obj->scale);
+        // 与渲染使用同一个模型矩阵，旋转顺序一致
+        glm::mat4 model = obj->ModelMatrix();
 
         glm::mat4 invModel = glm::inverse(model);
         glm::vec3 rayOriginLocal = glm::vec3(invModel * glm::vec4(rayOriginWorld, 1.0f));
         glm::vec3 rayDirLocal = glm::vec3(invModel * glm::vec4(rayDirWorld, 0.0f));
 
+        // [新增] 按网格自身的局部包围盒检测（流式网格使用导入时统计的包围盒）
+        BoundingVolume bounds = ObjectBounds(obj);
+        glm::vec3 boxMin = bounds.min;
+        glm::vec3 boxMax = bounds.max;
+
         float t = 0.0f;
-        if (IntersectRayAABB(rayOriginLocal, rayDirLocal, glm::vec3(-0.5f), glm::vec3(0.5f), t))
+        if (IntersectRayAABB(rayOriginLocal, rayDirLocal, boxMin, boxMax, t))
         {
             glm::vec3 hitPointLocal = rayOriginLocal + rayDirLocal * t;
             glm::vec3 hitPointWorld = glm::vec3(model * glm::vec4(hitPointLocal, 1.0f));
@@ -373,24 +471,88 @@ void Application::RenderScene()
     if (!mainShader || !scene || !camera)
         return;
 
+    glm::mat4 projection = glm::perspective(glm::radians(camera->Zoom), (float)scrWidth / (float)scrHeight, 0.1f, 100.0f);
+    glm::mat4 view = camera->GetViewMatrix();
+    PartC::Renderer::BeginFrame(camera->Position, projection * view, glm::radians(camera->Zoom), scrHeight);
+
+    // 每个对象的模型矩阵每帧只计算一次，三个阶段共用
+    objectModels.resize(scene->objects.size());
+    for (size_t i = 0; i < scene->objects.size(); i++)
+        objectModels[i] = scene->objects[i]->ModelMatrix();
+
+    // [新增] 阴影贴图覆盖全部对象世界包围球的外接范围
+    {
+        glm::vec3 sceneMin(std::numeric_limits<float>::max());
+        glm::vec3 sceneMax(-std::numeric_limits<float>::max());
+        for (size_t i = 0; i < scene->objects.size(); i++)
+        {
+            glm::vec3 center;
+            float radius;
+            ObjectBounds(scene->objects[i]).WorldSphere(objectModels[i], center, radius);
+            sceneMin = glm::min(sceneMin, center - glm::vec3(radius));
+            sceneMax = glm::max(sceneMax, center + glm::vec3(radius));
+        }
+        if (!scene->objects.empty())
+            PartC::Renderer::FitShadowBounds((sceneMin + sceneMax) * 0.5f, glm::length(sceneMax - sceneMin) * 0.5f);
+    }
+
+    // ------------------------------------------------
+    // 0. Page streamed chunks around the camera
+    // ------------------------------------------------
+    for (size_t i = 0; i < scene->objects.size(); i++)
+    {
+        SceneObject *obj = scene->objects[i];
+        if (!obj->chunkedMesh)
+            continue;
+        const glm::mat4 &model = objectModels[i];
+
+        // 在物体局部空间中以相机为中心、远裁剪面距离为半径选取常驻块
+        glm::vec3 cameraLocal = glm::vec3(glm::inverse(model) * glm::vec4(camera->Position, 1.0f));
+        float minScale = std::max(1e-6f, std::min(std::fabs(obj->scale.x), std::min(std::fabs(obj->scale.y), std::fabs(obj->scale.z))));
+        obj->chunkedMesh->UpdateResidency(cameraLocal, 100.0f / minScale, static_cast<size_t>(residentBudgetMB) * 1024 * 1024);
+    }
+
+    // [新增] 动态网格：本帧顶点写入环形缓冲的下一段（不等待 GPU 读取上一帧的数据）
+    for (SceneObject *obj : scene->objects)
+    {
+        if (obj->dynamicMesh)
+            GeometryUtils::UpdateWaveGrid(obj->dynamicMesh, WAVE_RESOLUTION, static_cast<float>(glfwGetTime()));
+    }
+
     // ------------------------------------------------
     // 1. Render Shadow Map (Pass 1)
     // ------------------------------------------------
+    // [新增] 共享网格的对象按 (网格, LOD) 合并为实例化绘制
     PartC::Renderer::BeginShadowMap();
-    for (auto obj : scene->objects)
+    Shader &depthShader = *PartC::Renderer::depthShader;
+    instanceBatcher->Begin();
+    for (size_t i = 0; i < scene->objects.size(); i++)
     {
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, obj->position);
-        model = glm::rotate(model, glm::radians(obj->rotation.x), glm::vec3(1, 0, 0));
-        model = glm::rotate(model, glm::radians(obj->rotation.y), glm::vec3(0, 1, 0));
-        model = glm::rotate(model, glm::radians(obj->rotation.z), glm::vec3(0, 0, 1));
-        model = glm::scale(model, obj->scale);
+        SceneObject *obj = scene->objects[i];
+        const glm::mat4 &model = objectModels[i];
 
         // Use depth shader (managed internally by Renderer)
-        PartC::Renderer::depthShader->setMat4("model", model);
         if (obj->mesh)
-            obj->mesh->Draw(*PartC::Renderer::depthShader);
+        {
+            int lod = PartC::Renderer::SelectLod(obj->mesh.get(), model);
+            if (!PartC::Renderer::instancing || !instanceBatcher->Add(obj->mesh.get(), lod, nullptr, model, obj->color))
+            {
+                depthShader.setMat4("model", model);
+                obj->mesh->DrawDepth(depthShader, lod);
+            }
+        }
+        if (obj->chunkedMesh)
+        {
+            depthShader.setMat4("model", model);
+            obj->chunkedMesh->DrawDepth(depthShader);
+        }
+        if (obj->dynamicMesh)
+        {
+            depthShader.setMat4("model", model);
+            obj->dynamicMesh->DrawDepth(depthShader);
+        }
     }
+    instanceBatcher->FlushDepth(depthShader);
     PartC::Renderer::EndShadowMap(scrWidth, scrHeight);
 
     // ------------------------------------------------
@@ -400,26 +562,47 @@ void Application::RenderScene()
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     mainShader->use();
-    glm::mat4 projection = glm::perspective(glm::radians(camera->Zoom), (float)scrWidth / (float)scrHeight, 0.1f, 100.0f);
-    glm::mat4 view = camera->GetViewMatrix();
     mainShader->setMat4("projection", projection);
     mainShader->setMat4("view", view);
 
     // [Part C] Use Renderer to setup lights (includes shadow map binding)
     PartC::Renderer::SetupLights(*mainShader, camera->Position);
 
-    for (auto obj : scene->objects)
+    // [新增] 视锥外的对象不提交；其余对象中共享网格与纹理的合并为实例化绘制
+    // 选中的对象单独绘制（之后还要画高亮线框）
+    instanceBatcher->Begin();
+    for (size_t i = 0; i < scene->objects.size(); i++)
     {
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, obj->position);
-        model = glm::rotate(model, glm::radians(obj->rotation.x), glm::vec3(1, 0, 0));
-        model = glm::rotate(model, glm::radians(obj->rotation.y), glm::vec3(0, 1, 0));
-        model = glm::rotate(model, glm::radians(obj->rotation.z), glm::vec3(0, 0, 1));
-        model = glm::scale(model, obj->scale);
+        SceneObject *obj = scene->objects[i];
+        const glm::mat4 &model = objectModels[i];
+        const Material *material = SceneContext::MaterialOf(obj);
 
-        // [Part C] Use Renderer to render mesh
-        mainShader->setVec3("objectColor", obj->color);
-        PartC::Renderer::RenderMesh(obj->mesh, *mainShader, model);
+        if (obj->mesh && PartC::Renderer::IsVisible(obj->mesh.get(), model))
+        {
+            bool batched = PartC::Renderer::instancing && obj != scene->selectedObject &&
+                           instanceBatcher->Add(obj->mesh.get(), PartC::Renderer::SelectLod(obj->mesh.get(), model),
+                                                material, model, obj->color);
+            if (!batched)
+            {
+                // [Part C] Use Renderer to render mesh
+                mainShader->setVec3("objectColor", obj->color);
+                PartC::Renderer::RenderMesh(obj->mesh.get(), *mainShader, model, material);
+            }
+        }
+        if (obj->chunkedMesh)
+        {
+            mainShader->setVec3("objectColor", obj->color);
+            mainShader->setMat4("model", model);
+            mainShader->setMat3("normalMatrix", glm::mat3(glm::transpose(glm::inverse(model))));
+            obj->chunkedMesh->Draw(*mainShader);
+        }
+        if (obj->dynamicMesh)
+        {
+            mainShader->setVec3("objectColor", obj->color);
+            mainShader->setMat4("model", model);
+            mainShader->setMat3("normalMatrix", glm::mat3(glm::transpose(glm::inverse(model))));
+            obj->dynamicMesh->Draw(*mainShader, material);
+        }
 
         if (obj == scene->selectedObject)
         {
@@ -433,12 +616,54 @@ void Application::RenderScene()
             // mainShader->setVec3("objectColor", glm::vec3(1.0f, 1.0f, 0.0f));
 
             if (obj->mesh)
-                obj->mesh->Draw(*mainShader);
+                obj->mesh->Draw(*mainShader, PartC::Renderer::SelectLod(obj->mesh.get(), model), material);
+            if (obj->chunkedMesh)
+                obj->chunkedMesh->Draw(*mainShader);
+            if (obj->dynamicMesh)
+                obj->dynamicMesh->Draw(*mainShader, material);
 
             glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
             glLineWidth(1.0f);
         }
     }
+    instanceBatcher->Flush(*mainShader);
+
+    if (benchmarkRequested)
+    {
+        RunDrawBenchmark();
+        benchmarkRequested = false;
+    }
+}
+
+void Application::RunDrawBenchmark()
+{
+    // 与未合批对象相同的逐次提交：模型矩阵、颜色、反量化参数与材质、绘制；不做视锥与簇剔除
+    // 先排空 GPU 队列，计时只包含 CPU 端的提交
+    glFinish();
+    const size_t bindsBefore = Material::textureBinds;
+    size_t draws = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < BENCHMARK_ROUNDS; round++)
+    {
+        for (size_t i = 0; i < scene->objects.size(); i++)
+        {
+            SceneObject *obj = scene->objects[i];
+            if (!obj->mesh)
+                continue;
+            mainShader->setMat4("model", objectModels[i]);
+            mainShader->setVec3("objectColor", obj->color);
+            obj->mesh->Draw(*mainShader, PartC::Renderer::SelectLod(obj->mesh.get(), objectModels[i]),
+                            SceneContext::MaterialOf(obj));
+            draws++;
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    benchmarkDraws = draws;
+    benchmarkBinds = Material::textureBinds - bindsBefore;
+    benchmarkNsPerDraw = draws > 0 ? ns / draws : 0.0;
+    std::cout << "Draw benchmark: " << draws << " draws, " << benchmarkNsPerDraw << " ns/draw, " << benchmarkBinds
+              << " texture binds" << std::endl;
 }
 
 void Application::RenderUI()
@@ -477,6 +702,41 @@ void Application::RenderUI()
     ImGui::ColorEdit3("Diffuse", (float *)&PartC::Renderer::mainLight.diffuse);
     ImGui::ColorEdit3("Specular", (float *)&PartC::Renderer::mainLight.specular);
 
+    // [新增] LOD：屏幕误差阈值越大，远处物体使用越粗的 LOD
+    ImGui::DragFloat("LOD Error (px)", &PartC::Renderer::lodErrorPixels, 0.1f, 0.0f, 32.0f);
+    // [新增] 逐簇剔除
+    ImGui::Checkbox("Cluster Culling", &PartC::Renderer::clusterCulling);
+    ImGui::Text("Triangles: %zu", PartC::Renderer::trianglesDrawn);
+    // [新增] 实例化绘制
+    ImGui::Checkbox("Instancing", &PartC::Renderer::instancing);
+    if (PartC::Renderer::instancedDraws > 0)
+        ImGui::Text("Instanced: %zu draws, %zu instances", PartC::Renderer::instancedDraws, PartC::Renderer::instancesDrawn);
+    if (GLExtensions::HasMultiDrawIndirect())
+    {
+        ImGui::Checkbox("Multi-draw indirect", &PartC::Renderer::multiDrawIndirect);
+        if (PartC::Renderer::indirectSubmits > 0)
+            ImGui::Text("Indirect: %zu submits, %zu commands", PartC::Renderer::indirectSubmits, PartC::Renderer::indirectCommands);
+    }
+    // [新增] 材质纹理绑定：实际绑定次数 / 因已绑定而省去的次数
+    ImGui::Text("Texture binds: %zu (skipped %zu)", Material::textureBinds, Material::bindsSkipped);
+    // [新增] 绘制调用基准（结果来自最近一次运行）
+    if (ImGui::Button("Benchmark Draws"))
+        benchmarkRequested = true;
+    if (benchmarkDraws > 0)
+    {
+        ImGui::SameLine();
+        ImGui::Text("%.0f ns/draw (%zu draws, %zu binds)", benchmarkNsPerDraw, benchmarkDraws, benchmarkBinds);
+    }
+    if (PartC::Renderer::clustersTested > 0)
+        ImGui::Text("Clusters: %zu / %zu visible", PartC::Renderer::clustersDrawn, PartC::Renderer::clustersTested);
+    // [新增] 几何池占用
+    {
+        const GeometryArena &arena = GeometryArena::Get(GeometryArena::FORMAT_VERTEX);
+        ImGui::Text("Geometry arena: %zu / %zu vertices, %.1f MB", arena.VertexUsed(), arena.VertexCapacity(),
+                    arena.GpuBytes() / (1024.0 * 1024.0));
+        ImGui::Text("Shared meshes: %zu for %zu objects", MeshLibrary::LiveCount(), scene->objects.size());
+    }
+
     ImGui::Dummy(ImVec2(0, 5));
     ImGui::Text("CREATE & IMPORT");
     ImGui::Separator();
@@ -484,46 +744,94 @@ void Application::RenderUI()
     // [新增] 添加物体 UI
     if (ImGui::Button("Cube", ImVec2(60, 0)))
     {
-        Mesh *mesh = GeometryUtils::CreateCube();
-        SceneObject *newObj = new SceneObject("New Cube", mesh);
+        // 所有立方体共享同一个网格，只在第一次创建时上传
+        SceneObject *newObj = new SceneObject("New Cube", MeshLibrary::Cube());
         newObj->position = glm::vec3(0, 0.5f, 0); // 生成在地面上
         scene->AddObject(newObj);
     }
     ImGui::SameLine();
     if (ImGui::Button("Sphere", ImVec2(60, 0)))
     {
-        Mesh *mesh = GeometryUtils::CreateSphere(20, 20);
-        SceneObject *newObj = new SceneObject("New Sphere", mesh);
+        SceneObject *newObj = new SceneObject("New Sphere", MeshLibrary::Sphere(20, 20));
+        newObj->position = glm::vec3(0, 0.5f, 0);
+        scene->AddObject(newObj);
+    }
+    ImGui::SameLine();
+    // [新增] 每帧形变的波浪网格（动态顶点缓冲演示）
+    if (ImGui::Button("Wave", ImVec2(60, 0)))
+    {
+        SceneObject *newObj = new SceneObject("New Wave", nullptr);
+        newObj->dynamicMesh = GeometryUtils::CreateWaveGrid(WAVE_RESOLUTION);
         newObj->position = glm::vec3(0, 0.5f, 0);
+        newObj->scale = glm::vec3(2.0f);
         scene->AddObject(newObj);
     }
 
-    // [新增] 加载 OBJ UI
+    // [新增] 加载模型 UI（OBJ / STL / PLY / GLB）
     ImGui::Dummy(ImVec2(0, 5));
-    ImGui::Text("Import Model (.obj)");
+    ImGui::Text("Import Model (.obj/.stl/.ply/.glb)");
     ImGui::InputText("##objPath", objPathBuffer, sizeof(objPathBuffer));
     ImGui::SameLine();
-    if (ImGui::Button("Load"))
+    if (importTask)
     {
-        // 调用 Part B 接口
-        Mesh *imported = ModelLoader::LoadMesh(objPathBuffer);
-        if (imported)
+        // 导入进行中：显示进度与取消按钮，解析在后台线程执行，不阻塞渲染
+        if (ImGui::Button("Cancel"))
+            importTask->Cancel();
+        char overlay[64];
+        snprintf(overlay, sizeof(overlay), "%s %.0f%%", importTask->Stage(), importTask->Progress() * 100.0f);
+        ImGui::ProgressBar(importTask->Progress(), ImVec2(-1, 0), overlay);
+    }
+    else if (ImGui::Button("Load"))
+    {
+        // 同一文件（且未被修改）的网格仍在场景中时直接共享，不再重新导入和上传
+        std::string version = MeshLibrary::FileVersion(objPathBuffer);
+        MeshHandle loaded = streamingImport || version.empty()
+                                ? nullptr
+                                : MeshLibrary::Find(MeshLibrary::FileKey(objPathBuffer, packVertices, version));
+        if (loaded)
         {
-            SceneObject *newObj = new SceneObject("Imported Model", imported);
-            scene->AddObject(newObj);
+            scene->AddObject(new SceneObject("Imported Model", loaded));
         }
         else
         {
-            std::cout << "Failed to load model from " << objPathBuffer << std::endl;
+            // 调用 Part B 接口（后台线程）
+            ImportOptions options;
+            options.packVertices = packVertices;
+            options.compressCache = compressCache;
+            StreamingOptions streaming;
+            streaming.memoryBudget = static_cast<size_t>(streamingBudgetMB) * 1024 * 1024;
+            importVersion = version;
+            importTask = new ImportTask(objPathBuffer, options, streamingImport ? &streaming : nullptr);
         }
     }
 
+    // [新增] 流式导入：内存只受预算限制，适合超出内存的模型；按区域分块，渲染时按需载入
+    // [新增] 压缩顶点：位置 16 位量化、八面体法线、半精度 UV
+    ImGui::Checkbox("Compact vertices (16 B)", &packVertices);
+    // [新增] 压缩缓存：.meshbin 经 MeshCodec 编码，命中时并行解码
+    ImGui::Checkbox("Compressed cache", &compressCache);
+    ImGui::Checkbox("Out-of-core", &streamingImport);
+    if (streamingImport)
+    {
+        ImGui::DragInt("Import budget (MB)", &streamingBudgetMB, 16.0f, 64, 16384);
+        ImGui::DragInt("GPU budget (MB)", &residentBudgetMB, 16.0f, 16, 16384);
+    }
+
     // ---------------- 属性面板 ----------------
     if (scene->selectedObject)
     {
         ImGui::Dummy(ImVec2(0, 15));
         ImGui::Separator();
         ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.0f, 1.0f), "INSPECTOR: %s", scene->selectedObject->name.c_str());
+        if (Mesh *mesh = scene->selectedObject->mesh.get())
+            ImGui::Text("LODs: %d (LOD0 %u triangles), %zu B/vertex", mesh->LodCount(), mesh->LodIndexCount(0) / 3,
+                        mesh->VertexStride());
+        if (ChunkedMesh *chunked = scene->selectedObject->chunkedMesh)
+            ImGui::Text("Chunks: %zu / %zu resident (%.1f MB)", chunked->ResidentCount(), chunked->chunks.size(),
+                        chunked->ResidentBytes() / (1024.0 * 1024.0));
+        if (DynamicMesh *dynamic = scene->selectedObject->dynamicMesh)
+            ImGui::Text("Dynamic: %zu vertices, %s, %zu stalls", dynamic->VertexCount(),
+                        dynamic->IsPersistent() ? "persistent ring" : "orphaning", dynamic->StallCount());
 
         ImGui::Text("Transform");
         ImGui::DragFloat3("Pos", (float *)&scene->selectedObject->position, 0.05f);
@@ -562,19 +870,19 @@ void Application::RenderUI()
         {
             if (scene->selectedObject->mesh)
             {
-                // 1. 清除旧纹理
-                scene->selectedObject->mesh->textures.clear();
+                // 1. 清除旧纹理（纹理属于对象，不影响共享同一网格的其他对象）
+                scene->selectedObject->textures.clear();
 
                 // 2. 加载新纹理 (Part C 功能)
                 std::string path = texBuf;
                 Texture diffuseMap(path.c_str(), "diffuse");
                 Texture specularMap(path.c_str(), "specular"); // 暂时复用同一张图
 
-                // 3. 应用到 Mesh
+                // 3. 应用到对象
                 if (diffuseMap.id != 0)
                 {
-                    scene->selectedObject->mesh->textures.push_back(diffuseMap);
-                    scene->selectedObject->mesh->textures.push_back(specularMap);
+                    scene->selectedObject->textures.push_back(diffuseMap);
+                    scene->selectedObject->textures.push_back(specularMap);
                     scene->selectedObject->texturePath = path;
                     std::cout << "Successfully loaded texture: " << path << std::endl;
                 }
@@ -582,6 +890,7 @@ void Application::RenderUI()
                 {
                     std::cerr << "Failed to load texture: " << path << std::endl;
                 }
+                scene->selectedObject->material = Material(scene->selectedObject->textures);
             }
         }
 
@@ -0,0 +1,116 @@
+#include "BoundingVolume.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BOUNDING_VOLUME_SSE2 1
+#endif
+
+namespace
+{
+    inline const float *PositionAt(const void *positions, size_t index, size_t stride)
+    {
+        return reinterpret_cast<const float *>(static_cast<const char *>(positions) + index * stride);
+    }
+}
+
+BoundingVolume BoundingVolume::FromPositions(const void *positions, size_t count, size_t stride)
+{
+    BoundingVolume volume;
+    if (count == 0)
+        return volume;
+
+#ifdef BOUNDING_VOLUME_SSE2
+    // 每次读入 x, y, z 及其后的 4 字节（stride >= 16 保证不越界），第 4 个分量忽略
+    // 两路累加器交替使用，缩短 min/max 的依赖链
+    __m128 lo0 = _mm_loadu_ps(PositionAt(positions, 0, stride));
+    __m128 hi0 = lo0, lo1 = lo0, hi1 = lo0;
+    size_t i = 1;
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128 a = _mm_loadu_ps(PositionAt(positions, i, stride));
+        __m128 b = _mm_loadu_ps(PositionAt(positions, i + 1, stride));
+        lo0 = _mm_min_ps(lo0, a);
+        hi0 = _mm_max_ps(hi0, a);
+        lo1 = _mm_min_ps(lo1, b);
+        hi1 = _mm_max_ps(hi1, b);
+    }
+    if (i < count)
+    {
+        __m128 a = _mm_loadu_ps(PositionAt(positions, i, stride));
+        lo0 = _mm_min_ps(lo0, a);
+        hi0 = _mm_max_ps(hi0, a);
+    }
+    float lo[4], hi[4];
+    _mm_storeu_ps(lo, _mm_min_ps(lo0, lo1));
+    _mm_storeu_ps(hi, _mm_max_ps(hi0, hi1));
+    volume.min = glm::vec3(lo[0], lo[1], lo[2]);
+    volume.max = glm::vec3(hi[0], hi[1], hi[2]);
+#else
+    const float *first = PositionAt(positions, 0, stride);
+    volume.min = volume.max = glm::vec3(first[0], first[1], first[2]);
+    for (size_t i = 1; i < count; i++)
+    {
+        const float *p = PositionAt(positions, i, stride);
+        glm::vec3 position(p[0], p[1], p[2]);
+        volume.min = glm::min(volume.min, position);
+        volume.max = glm::max(volume.max, position);
+    }
+#endif
+
+    volume.center = (volume.min + volume.max) * 0.5f;
+
+    // 第二遍：到球心的最大平方距离
+    float maxDistance2 = 0.0f;
+    size_t k = 0;
+#ifdef BOUNDING_VOLUME_SSE2
+    // 每 4 个顶点转置为 x / y / z 三个向量，一次求 4 个平方距离
+    const __m128 cx = _mm_set1_ps(volume.center.x);
+    const __m128 cy = _mm_set1_ps(volume.center.y);
+    const __m128 cz = _mm_set1_ps(volume.center.z);
+    __m128 best = _mm_setzero_ps();
+    for (; k + 4 <= count; k += 4)
+    {
+        __m128 x = _mm_loadu_ps(PositionAt(positions, k, stride));
+        __m128 y = _mm_loadu_ps(PositionAt(positions, k + 1, stride));
+        __m128 z = _mm_loadu_ps(PositionAt(positions, k + 2, stride));
+        __m128 w = _mm_loadu_ps(PositionAt(positions, k + 3, stride));
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        __m128 dx = _mm_sub_ps(x, cx);
+        __m128 dy = _mm_sub_ps(y, cy);
+        __m128 dz = _mm_sub_ps(z, cz);
+        __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        best = _mm_max_ps(best, d2);
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, best);
+    maxDistance2 = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+#endif
+    for (; k < count; k++)
+    {
+        const float *p = PositionAt(positions, k, stride);
+        glm::vec3 d = glm::vec3(p[0], p[1], p[2]) - volume.center;
+        maxDistance2 = std::max(maxDistance2, glm::dot(d, d));
+    }
+    volume.radius = std::sqrt(maxDistance2);
+    return volume;
+}
+
+BoundingVolume BoundingVolume::FromBox(const glm::vec3 &min, const glm::vec3 &max)
+{
+    BoundingVolume volume;
+    volume.min = min;
+    volume.max = max;
+    volume.center = (min + max) * 0.5f;
+    volume.radius = glm::length(max - min) * 0.5f;
+    return volume;
+}
+
+void BoundingVolume::WorldSphere(const glm::mat4 &model, glm::vec3 &worldCenter, float &worldRadius) const
+{
+    worldCenter = glm::vec3(model * glm::vec4(center, 1.0f));
+    float scale = std::max(glm::length(glm::vec3(model[0])),
+                           std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+    worldRadius = radius * scale;
+}
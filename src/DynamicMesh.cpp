@@ -0,0 +1,157 @@
+#include "DynamicMesh.h"
+#include "GLExtensions.h"
+#include "GeometryArena.h"
+#include "IndexFormat.h"
+#include "Mesh.h"
+#include "VertexFormat.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+DynamicMesh::DynamicMesh(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices)
+    : vertexCount(vertices.size()), indexCount(static_cast<GLsizei>(indices.size()))
+{
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &EBO);
+    GeometryArena::BindVertexArray(VAO);
+
+    if (!CreatePersistentBuffer(vertices))
+    {
+        // 回退：单段缓冲，每次更新时孤立旧存储，驱动为新数据另行分配
+        staging = vertices;
+        glGenBuffers(1, &VBO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STREAM_DRAW);
+    }
+
+    std::vector<uint16_t> shortIndices;
+    const void *indexData = IndexFormat::Prepare(indices.data(), indices.size(), vertexCount, shortIndices, indexType);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * IndexFormat::Size(indexType), indexData, GL_STATIC_DRAW);
+
+    VertexFormat::Apply<Vertex>();
+
+    std::cout << "[DynamicMesh] " << vertexCount << " vertices, "
+              << (IsPersistent() ? "persistent-mapped ring" : "orphaning fallback") << std::endl;
+}
+
+DynamicMesh::~DynamicMesh()
+{
+    for (GLsync &fence : fences)
+    {
+        if (fence)
+            glDeleteSync(fence);
+        fence = nullptr;
+    }
+    if (mapped)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+    GeometryArena::ForgetVertexArray(VAO);
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+}
+
+bool DynamicMesh::CreatePersistentBuffer(const std::vector<Vertex> &vertices)
+{
+    if (!GLExtensions::HasBufferStorage() || vertexCount == 0)
+        return false;
+
+    // 一致性映射：写入对 GPU 自动可见，无需 glFlushMappedBufferRange
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const size_t sectionBytes = vertexCount * sizeof(Vertex);
+    glGenBuffers(1, &VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLExtensions::BufferStorage(GL_ARRAY_BUFFER, sectionBytes * RING_SIZE, nullptr, flags);
+    mapped = static_cast<Vertex *>(glMapBufferRange(GL_ARRAY_BUFFER, 0, sectionBytes * RING_SIZE, flags));
+    if (!mapped)
+    {
+        // 不可变存储无法重新分配，换一个缓冲走回退路径
+        std::cerr << "[DynamicMesh] Persistent mapping failed, falling back to orphaning" << std::endl;
+        glDeleteBuffers(1, &VBO);
+        VBO = 0;
+        return false;
+    }
+
+    std::memcpy(mapped, vertices.data(), sectionBytes);
+    drawSection = 0;
+    return true;
+}
+
+void DynamicMesh::WaitFence(unsigned int section)
+{
+    GLsync &fence = fences[section];
+    if (!fence)
+        return;
+
+    // 先不等待地查询一次；未完成时才计为一次停顿
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED)
+    {
+        stalls++;
+        do
+        {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+Vertex *DynamicMesh::BeginUpdate()
+{
+    if (!mapped)
+        return staging.data();
+
+    writeSection = (drawSection + 1) % RING_SIZE;
+    WaitFence(writeSection);
+    return mapped + writeSection * vertexCount;
+}
+
+void DynamicMesh::EndUpdate()
+{
+    if (mapped)
+    {
+        drawSection = writeSection;
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, staging.size() * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, staging.size() * sizeof(Vertex), staging.data());
+}
+
+void DynamicMesh::Draw(Shader &shader, const Material *material)
+{
+    static const Material untextured;
+    // 着色器中的反量化参数可能还是上一个压缩网格的，这里恢复为恒等参数
+    Mesh::SetQuantization(shader, false, VertexQuantization());
+    (material ? *material : untextured).Bind(shader);
+    Submit();
+}
+
+void DynamicMesh::DrawDepth(Shader &shader)
+{
+    // 深度着色器对所有网格都做反量化，这里给恒等参数
+    Mesh::SetQuantization(shader, false, VertexQuantization());
+    Submit();
+}
+
+void DynamicMesh::Submit()
+{
+    GeometryArena::BindVertexArray(VAO);
+    GLint baseVertex = mapped ? static_cast<GLint>(drawSection * vertexCount) : 0;
+    glDrawElementsBaseVertex(GL_TRIANGLES, indexCount, indexType, (void *)0, baseVertex);
+
+    if (mapped)
+    {
+        // 同一帧多次绘制（阴影、主渲染、高亮）时只保留最后一次的栅栏
+        GLsync &fence = fences[drawSection];
+        if (fence)
+            glDeleteSync(fence);
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+}
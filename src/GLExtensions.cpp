@@ -0,0 +1,46 @@
+#include "GLExtensions.h"
+#include <cstring>
+#include <iostream>
+
+GLMultiDrawElementsIndirectProc GLExtensions::MultiDrawElementsIndirect = nullptr;
+GLBufferStorageProc GLExtensions::BufferStorage = nullptr;
+int GLExtensions::majorVersion = 0;
+int GLExtensions::minorVersion = 0;
+
+bool GLExtensions::HasExtension(const char *name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++)
+    {
+        const char *extension = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, i));
+        if (extension && std::strcmp(extension, name) == 0)
+            return true;
+    }
+    return false;
+}
+
+void GLExtensions::Load(GLADloadproc loader)
+{
+    glGetIntegerv(GL_MAJOR_VERSION, &majorVersion);
+    glGetIntegerv(GL_MINOR_VERSION, &minorVersion);
+    const int version = majorVersion * 10 + minorVersion;
+
+    MultiDrawElementsIndirect = nullptr;
+    bool multiDraw = version >= 43 || HasExtension("GL_ARB_multi_draw_indirect");
+    bool baseInstance = version >= 42 || HasExtension("GL_ARB_base_instance");
+    if (multiDraw && baseInstance)
+    {
+        // ARB_multi_draw_indirect 与核心函数同名（无后缀）
+        MultiDrawElementsIndirect =
+            reinterpret_cast<GLMultiDrawElementsIndirectProc>(loader("glMultiDrawElementsIndirect"));
+    }
+
+    BufferStorage = nullptr;
+    if (version >= 44 || HasExtension("GL_ARB_buffer_storage"))
+        BufferStorage = reinterpret_cast<GLBufferStorageProc>(loader("glBufferStorage"));
+
+    std::cout << "[GLExtensions] OpenGL " << majorVersion << "." << minorVersion
+              << ", multi-draw indirect: " << (HasMultiDrawIndirect() ? "yes" : "no")
+              << ", buffer storage: " << (HasBufferStorage() ? "yes" : "no") << std::endl;
+}
@@ -0,0 +1,247 @@
+#include "GeometryArena.h"
+#include "Common.h"
+#include "VertexFormat.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+GeometryArena *GeometryArena::arenas[GeometryArena::FORMAT_COUNT] = {};
+unsigned int GeometryArena::boundVertexArray = 0;
+
+// ---------------- RangeAllocator ----------------
+
+bool RangeAllocator::Allocate(size_t size, size_t &offset)
+{
+    if (size == 0)
+    {
+        offset = 0;
+        return true;
+    }
+    for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it)
+    {
+        if (it->second < size)
+            continue;
+        offset = it->first;
+        size_t remaining = it->second - size;
+        freeRanges.erase(it);
+        if (remaining > 0)
+            freeRanges[offset + size] = remaining;
+        used += size;
+        return true;
+    }
+    return false;
+}
+
+void RangeAllocator::Free(size_t offset, size_t size)
+{
+    if (size == 0)
+        return;
+    used -= size;
+
+    auto next = freeRanges.lower_bound(offset);
+    // 与后一个空闲区间相邻：合并
+    if (next != freeRanges.end() && offset + size == next->first)
+    {
+        size += next->second;
+        next = freeRanges.erase(next);
+    }
+    // 与前一个空闲区间相邻：并入前者
+    if (next != freeRanges.begin())
+    {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset)
+        {
+            previous->second += size;
+            return;
+        }
+    }
+    freeRanges[offset] = size;
+}
+
+void RangeAllocator::Grow(size_t newCapacity)
+{
+    if (newCapacity <= capacity)
+        return;
+    size_t oldCapacity = capacity;
+    capacity = newCapacity;
+    // 借用 Free 的合并逻辑，Free 会减去 used，这里先补回
+    used += newCapacity - oldCapacity;
+    Free(oldCapacity, newCapacity - oldCapacity);
+}
+
+// ---------------- GeometryArena ----------------
+
+GeometryArena &GeometryArena::Get(Format format)
+{
+    if (!arenas[format])
+        arenas[format] = new GeometryArena(format);
+    return *arenas[format];
+}
+
+void GeometryArena::DestroyAll()
+{
+    for (GeometryArena *&arena : arenas)
+    {
+        delete arena;
+        arena = nullptr;
+    }
+}
+
+void GeometryArena::BindVertexArray(unsigned int array)
+{
+    if (array == boundVertexArray)
+        return;
+    glBindVertexArray(array);
+    boundVertexArray = array;
+}
+
+void GeometryArena::ForgetVertexArray(unsigned int array)
+{
+    // 删除当前绑定的 VAO 时 GL 会回退到 0
+    if (array == boundVertexArray)
+        boundVertexArray = 0;
+}
+
+GeometryArena::GeometryArena(Format format)
+    : format(format), stride(format == FORMAT_PACKED ? sizeof(PackedVertex) : sizeof(Vertex)),
+      positionStride(format == FORMAT_PACKED ? sizeof(PackedPosition) : sizeof(PositionVertex))
+{
+    vertices.Grow(INITIAL_VERTICES);
+    indexWords.Grow(INITIAL_INDEX_WORDS);
+    vbo = GrowBuffer(0, 0, INITIAL_VERTICES * stride);
+    positionVbo = GrowBuffer(0, 0, INITIAL_VERTICES * positionStride);
+    ebo = GrowBuffer(0, 0, INITIAL_INDEX_WORDS * INDEX_WORD);
+    SetupVertexArray();
+}
+
+GeometryArena::~GeometryArena()
+{
+    ForgetVertexArray(vao);
+    ForgetVertexArray(depthVao);
+    glDeleteVertexArrays(1, &vao);
+    glDeleteVertexArrays(1, &depthVao);
+    glDeleteBuffers(1, &vbo);
+    glDeleteBuffers(1, &positionVbo);
+    glDeleteBuffers(1, &ebo);
+}
+
+unsigned int GeometryArena::GrowBuffer(unsigned int buffer, size_t oldBytes, size_t newBytes)
+{
+    // 使用 COPY 绑定点，不会改动当前 VAO 记录的 EBO
+    unsigned int grown;
+    glGenBuffers(1, &grown);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, grown);
+    glBufferData(GL_COPY_WRITE_BUFFER, newBytes, nullptr, GL_STATIC_DRAW);
+    if (buffer != 0)
+    {
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldBytes);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glDeleteBuffers(1, &buffer);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return grown;
+}
+
+void GeometryArena::SetupVertexArray()
+{
+    if (vao == 0)
+        glGenVertexArrays(1, &vao);
+    BindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+
+    if (format == FORMAT_PACKED)
+        VertexFormat::Apply<PackedVertex>();
+    else
+        VertexFormat::Apply<Vertex>();
+
+    if (depthVao == 0)
+        glGenVertexArrays(1, &depthVao);
+    BindVertexArray(depthVao);
+    glBindBuffer(GL_ARRAY_BUFFER, positionVbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    if (format == FORMAT_PACKED)
+        VertexFormat::Apply<PackedPosition>();
+    else
+        VertexFormat::Apply<PositionVertex>();
+}
+
+const void *GeometryArena::ExtractPositions(const void *vertexData, size_t vertexCount,
+                                           std::vector<unsigned char> &storage) const
+{
+    storage.resize(vertexCount * positionStride);
+    if (format == FORMAT_PACKED)
+    {
+        const PackedVertex *source = static_cast<const PackedVertex *>(vertexData);
+        PackedPosition *target = reinterpret_cast<PackedPosition *>(storage.data());
+        for (size_t i = 0; i < vertexCount; i++)
+            std::memcpy(target[i].Position, source[i].Position, sizeof(target[i].Position));
+    }
+    else
+    {
+        const Vertex *source = static_cast<const Vertex *>(vertexData);
+        PositionVertex *target = reinterpret_cast<PositionVertex *>(storage.data());
+        for (size_t i = 0; i < vertexCount; i++)
+            target[i].Position = source[i].Position;
+    }
+    return storage.data();
+}
+
+bool GeometryArena::Allocate(const void *vertexData, size_t vertexCount, const void *indexData, size_t indexCount,
+                             size_t indexSize, GeometryRange &range)
+{
+    const size_t wordCount = IndexWords(indexCount, indexSize);
+    size_t vertexOffset, wordOffset;
+    if (!vertices.Allocate(vertexCount, vertexOffset))
+    {
+        size_t oldCapacity = vertices.Capacity();
+        vertices.Grow(std::max(oldCapacity * 2, oldCapacity + vertexCount));
+        vbo = GrowBuffer(vbo, oldCapacity * stride, vertices.Capacity() * stride);
+        positionVbo = GrowBuffer(positionVbo, oldCapacity * positionStride, vertices.Capacity() * positionStride);
+        SetupVertexArray();
+        std::cout << "[GeometryArena] Vertex buffer grown to " << vertices.Capacity() << " vertices" << std::endl;
+        if (!vertices.Allocate(vertexCount, vertexOffset))
+            return false;
+    }
+    if (!indexWords.Allocate(wordCount, wordOffset))
+    {
+        size_t oldCapacity = indexWords.Capacity();
+        indexWords.Grow(std::max(oldCapacity * 2, oldCapacity + wordCount));
+        ebo = GrowBuffer(ebo, oldCapacity * INDEX_WORD, indexWords.Capacity() * INDEX_WORD);
+        SetupVertexArray();
+        std::cout << "[GeometryArena] Index buffer grown to " << IndexBytesCapacity() / 1024 << " KB" << std::endl;
+        if (!indexWords.Allocate(wordCount, wordOffset))
+        {
+            vertices.Free(vertexOffset, vertexCount);
+            return false;
+        }
+    }
+
+    range.baseVertex = static_cast<unsigned int>(vertexOffset);
+    range.vertexCount = static_cast<unsigned int>(vertexCount);
+    range.firstIndex = static_cast<unsigned int>(wordOffset * INDEX_WORD / indexSize);
+    range.indexCount = static_cast<unsigned int>(indexCount);
+    range.indexSize = static_cast<unsigned int>(indexSize);
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, vertexOffset * stride, vertexCount * stride, vertexData);
+    std::vector<unsigned char> positions;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, positionVbo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, vertexOffset * positionStride, vertexCount * positionStride,
+                    ExtractPositions(vertexData, vertexCount, positions));
+    glBindBuffer(GL_COPY_WRITE_BUFFER, ebo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, wordOffset * INDEX_WORD, indexCount * indexSize, indexData);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return true;
+}
+
+void GeometryArena::Free(const GeometryRange &range)
+{
+    vertices.Free(range.baseVertex, range.vertexCount);
+    indexWords.Free(static_cast<size_t>(range.firstIndex) * range.indexSize / INDEX_WORD,
+                    IndexWords(range.indexCount, range.indexSize));
+}
@@ -1,6 +1,28 @@
 #include "GeometryUtils.h"
+#include "DynamicMesh.h"
+#include "MeshOptimizer.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <utility>
 #include <vector>
 
+namespace
+{
+    const float WAVE_AMPLITUDE = 0.05f;
+    const float WAVE_FREQUENCY = 12.0f;
+
+    // 波浪高度场 y = A sin(kx + t) cos(kz + 0.7t) 上的一个顶点，法线由偏导数解析求得
+    Vertex WaveVertex(float u, float v, float time)
+    {
+        float x = u - 0.5f, z = v - 0.5f;
+        float sx = std::sin(WAVE_FREQUENCY * x + time), cx = std::cos(WAVE_FREQUENCY * x + time);
+        float sz = std::sin(WAVE_FREQUENCY * z + 0.7f * time), cz = std::cos(WAVE_FREQUENCY * z + 0.7f * time);
+        float dydx = WAVE_AMPLITUDE * WAVE_FREQUENCY * cx * cz;
+        float dydz = -WAVE_AMPLITUDE * WAVE_FREQUENCY * sx * sz;
+        return {glm::vec3(x, WAVE_AMPLITUDE * sx * cz, z), glm::normalize(glm::vec3(-dydx, 1.0f, -dydz)), glm::vec2(u, v)};
+    }
+}
+
 // 辅助函数：添加面的两个三角形
 void AddFace(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, 
              glm::vec3 a, glm::vec3 b, glm::vec3 c, glm::vec3 d, glm::vec3 normal) {
@@ -42,7 +64,8 @@ Mesh* GeometryUtils::CreateCube() {
     // 下面
     AddFace(vertices, indices, p4, p5, p1, p0, glm::vec3(0, -1, 0));
 
-    return new Mesh(vertices, indices, textures);
+    MeshOptimizer::Optimize(vertices, indices, false);
+    return new Mesh(std::move(vertices), std::move(indices), std::move(textures), MeshResidency::ReleaseAfterUpload);
 }
 
 Mesh* GeometryUtils::CreateSphere(int latitudeSegments, int longitudeSegments) {
@@ -89,5 +112,40 @@ Mesh* GeometryUtils::CreateSphere(int latitudeSegments, int longitudeSegments) {
     vertices.push_back(vTop); vertices.push_back({base3, normal, {0,0}}); vertices.push_back({base0, normal, {1,0}});
     indices.push_back(start); indices.push_back(start+1); indices.push_back(start+2);
 
-    return new Mesh(vertices, indices, textures);
-}
\ No newline at end of file
+    MeshOptimizer::Optimize(vertices, indices, false);
+    return new Mesh(std::move(vertices), std::move(indices), std::move(textures), MeshResidency::ReleaseAfterUpload);
+}
+
+DynamicMesh* GeometryUtils::CreateWaveGrid(int resolution) {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    unsigned int row = resolution + 1;
+    for (int j = 0; j <= resolution; j++) {
+        for (int i = 0; i <= resolution; i++) {
+            vertices.push_back(WaveVertex(float(i) / resolution, float(j) / resolution, 0.0f));
+        }
+    }
+    for (int j = 0; j < resolution; j++) {
+        for (int i = 0; i < resolution; i++) {
+            unsigned int a = j * row + i;
+            indices.push_back(a); indices.push_back(a + row); indices.push_back(a + 1);
+            indices.push_back(a + 1); indices.push_back(a + row); indices.push_back(a + row + 1);
+        }
+    }
+
+    DynamicMesh* mesh = new DynamicMesh(vertices, indices);
+    mesh->bounds = BoundingVolume::FromBox(glm::vec3(-0.5f, -WAVE_AMPLITUDE, -0.5f), glm::vec3(0.5f, WAVE_AMPLITUDE, 0.5f));
+    return mesh;
+}
+
+void GeometryUtils::UpdateWaveGrid(DynamicMesh* mesh, int resolution, float time) {
+    // 写入的是（可能持久映射的）显存，每个顶点只写一次、按顺序写
+    Vertex* out = mesh->BeginUpdate();
+    unsigned int row = resolution + 1;
+    ThreadPool::Global().ParallelFor(row, [&](size_t j) {
+        Vertex* line = out + j * row;
+        for (unsigned int i = 0; i < row; i++)
+            line[i] = WaveVertex(float(i) / resolution, float(j) / resolution, time);
+    });
+    mesh->EndUpdate();
+}
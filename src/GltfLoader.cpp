@@ -0,0 +1,701 @@
+#include "GltfLoader.h"
+#include "ImportProgress.h"
+#include "JsonValue.h"
+#include "NormalGenerator.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+    const uint32_t GLB_MAGIC = 0x46546C67;      // "glTF"
+    const uint32_t CHUNK_JSON = 0x4E4F534A;     // "JSON"
+    const uint32_t CHUNK_BIN = 0x004E4942;      // "BIN\0"
+    const size_t GLB_HEADER_BYTES = 12;
+    const size_t CHUNK_HEADER_BYTES = 8;
+
+    // accessor.componentType，数值与对应的 GL 枚举相同
+    const int COMPONENT_BYTE = 5120;
+    const int COMPONENT_UNSIGNED_BYTE = 5121;
+    const int COMPONENT_SHORT = 5122;
+    const int COMPONENT_UNSIGNED_SHORT = 5123;
+    const int COMPONENT_UNSIGNED_INT = 5125;
+    const int COMPONENT_FLOAT = 5126;
+
+    const int MODE_TRIANGLES = 4;
+    // 节点层级深度上限（防止循环引用）
+    const int MAX_NODE_DEPTH = 64;
+
+    // 访问器解析后在 BIN 块中的位置
+    struct AccessorView
+    {
+        size_t offset = 0;
+        size_t stride = 0;
+        size_t count = 0;
+        int componentType = 0;
+        int components = 0;
+        bool normalized = false;
+        bool hasBounds = false;
+        glm::vec3 min = glm::vec3(0.0f);
+        glm::vec3 max = glm::vec3(0.0f);
+    };
+
+    size_t ComponentSize(int componentType)
+    {
+        switch (componentType)
+        {
+        case COMPONENT_BYTE:
+        case COMPONENT_UNSIGNED_BYTE:
+            return 1;
+        case COMPONENT_SHORT:
+        case COMPONENT_UNSIGNED_SHORT:
+            return 2;
+        case COMPONENT_UNSIGNED_INT:
+        case COMPONENT_FLOAT:
+            return 4;
+        default:
+            return 0;
+        }
+    }
+
+    int ComponentCount(const std::string &type)
+    {
+        if (type == "SCALAR")
+            return 1;
+        if (type == "VEC2")
+            return 2;
+        if (type == "VEC3")
+            return 3;
+        if (type == "VEC4")
+            return 4;
+        return 0;
+    }
+
+    int IndexOf(const JsonValue &object, const char *key)
+    {
+        return static_cast<int>(object.Number(key, -1.0));
+    }
+
+    // 读取一个分量并转换为 float（normalized 整数按 glTF 规则映射到 [-1, 1] / [0, 1]）
+    float ReadComponent(const char *p, int componentType, bool normalized)
+    {
+        switch (componentType)
+        {
+        case COMPONENT_BYTE:
+        {
+            int8_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return normalized ? std::max(v / 127.0f, -1.0f) : v;
+        }
+        case COMPONENT_UNSIGNED_BYTE:
+        {
+            uint8_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return normalized ? v / 255.0f : v;
+        }
+        case COMPONENT_SHORT:
+        {
+            int16_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return normalized ? std::max(v / 32767.0f, -1.0f) : v;
+        }
+        case COMPONENT_UNSIGNED_SHORT:
+        {
+            uint16_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return normalized ? v / 65535.0f : v;
+        }
+        case COMPONENT_UNSIGNED_INT:
+        {
+            uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return static_cast<float>(v);
+        }
+        case COMPONENT_FLOAT:
+        {
+            float v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+        default:
+            return 0.0f;
+        }
+    }
+
+    uint32_t ReadIndex(const char *p, int componentType)
+    {
+        if (componentType == COMPONENT_UNSIGNED_BYTE)
+            return static_cast<uint8_t>(*p);
+        if (componentType == COMPONENT_UNSIGNED_SHORT)
+        {
+            uint16_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    glm::mat4 LocalTransform(const JsonValue &node)
+    {
+        const JsonValue *matrix = node.Find("matrix");
+        if (matrix && matrix->Size() == 16)
+        {
+            // glTF 矩阵为列主序，与 glm 一致
+            glm::mat4 m(1.0f);
+            for (int c = 0; c < 4; c++)
+                for (int r = 0; r < 4; r++)
+                    if ((*matrix)[c * 4 + r].IsNumber())
+                        m[c][r] = static_cast<float>((*matrix)[c * 4 + r].number);
+            return m;
+        }
+
+        glm::vec3 t(0.0f), s(1.0f);
+        float q[4] = {0.0f, 0.0f, 0.0f, 1.0f}; // x, y, z, w
+        const JsonValue *translation = node.Find("translation");
+        const JsonValue *rotation = node.Find("rotation");
+        const JsonValue *scale = node.Find("scale");
+        for (int i = 0; i < 3; i++)
+        {
+            if (translation && translation->Size() == 3 && (*translation)[i].IsNumber())
+                t[i] = static_cast<float>((*translation)[i].number);
+            if (scale && scale->Size() == 3 && (*scale)[i].IsNumber())
+                s[i] = static_cast<float>((*scale)[i].number);
+        }
+        for (int i = 0; i < 4; i++)
+            if (rotation && rotation->Size() == 4 && (*rotation)[i].IsNumber())
+                q[i] = static_cast<float>((*rotation)[i].number);
+
+        // M = T * R * S
+        float x = q[0], y = q[1], z = q[2], w = q[3];
+        glm::mat4 m(1.0f);
+        m[0] = glm::vec4(1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + z * w), 2.0f * (x * z - y * w), 0.0f) * s.x;
+        m[1] = glm::vec4(2.0f * (x * y - z * w), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + x * w), 0.0f) * s.y;
+        m[2] = glm::vec4(2.0f * (x * z + y * w), 2.0f * (y * z - x * w), 1.0f - 2.0f * (x * x + y * y), 0.0f) * s.z;
+        m[3] = glm::vec4(t, 1.0f);
+        return m;
+    }
+
+    class GltfDocument
+    {
+    public:
+        JsonValue json;
+        const char *binary = nullptr;
+        size_t binarySize = 0;
+
+        bool ResolveAccessor(int index, AccessorView &view) const
+        {
+            const JsonValue *accessors = json.Find("accessors");
+            if (!accessors || index < 0 || static_cast<size_t>(index) >= accessors->Size())
+                return false;
+            const JsonValue &accessor = (*accessors)[index];
+            // 稀疏访问器与没有 bufferView 的访问器（全零）不支持
+            if (accessor.Find("sparse"))
+                return false;
+
+            const JsonValue *bufferViews = json.Find("bufferViews");
+            int viewIndex = IndexOf(accessor, "bufferView");
+            if (!bufferViews || viewIndex < 0 || static_cast<size_t>(viewIndex) >= bufferViews->Size())
+                return false;
+            const JsonValue &bufferView = (*bufferViews)[viewIndex];
+
+            // 只接受 GLB 内嵌的 0 号缓冲（没有 uri）
+            const JsonValue *buffers = json.Find("buffers");
+            if (IndexOf(bufferView, "buffer") != 0 || !buffers || buffers->Size() == 0 || (*buffers)[0].Find("uri"))
+                return false;
+
+            view.componentType = IndexOf(accessor, "componentType");
+            view.components = ComponentCount(accessor.String("type"));
+            view.count = static_cast<size_t>(accessor.Number("count", 0.0));
+            const JsonValue *normalized = accessor.Find("normalized");
+            view.normalized = normalized && normalized->type == JsonValue::Type::Bool && normalized->boolean;
+
+            size_t elementBytes = ComponentSize(view.componentType) * view.components;
+            if (elementBytes == 0)
+                return false;
+            size_t viewOffset = static_cast<size_t>(bufferView.Number("byteOffset", 0.0));
+            size_t viewLength = static_cast<size_t>(bufferView.Number("byteLength", 0.0));
+            size_t byteStride = static_cast<size_t>(bufferView.Number("byteStride", 0.0));
+            view.stride = byteStride > 0 ? byteStride : elementBytes;
+            view.offset = viewOffset + static_cast<size_t>(accessor.Number("byteOffset", 0.0));
+
+            if (viewOffset > binarySize || viewLength > binarySize - viewOffset)
+                return false;
+            if (view.count > 0 && (view.offset > viewOffset + viewLength ||
+                                   (view.count - 1) > (viewOffset + viewLength - view.offset) / view.stride ||
+                                   view.offset + (view.count - 1) * view.stride + elementBytes > viewOffset + viewLength))
+                return false;
+
+            const JsonValue *min = accessor.Find("min");
+            const JsonValue *max = accessor.Find("max");
+            if (view.components == 3 && min && max && min->Size() == 3 && max->Size() == 3)
+            {
+                view.hasBounds = true;
+                for (int i = 0; i < 3; i++)
+                {
+                    view.min[i] = static_cast<float>((*min)[i].number);
+                    view.max[i] = static_cast<float>((*max)[i].number);
+                }
+            }
+            return true;
+        }
+    };
+
+    bool IsFloatAttribute(const AccessorView &view, int components)
+    {
+        // GL 要求顶点属性的偏移与跨度按 4 字节对齐
+        return view.componentType == COMPONENT_FLOAT && view.components == components && view.offset % 4 == 0 &&
+               view.stride % 4 == 0;
+    }
+
+    // 返回最大索引；用于确认 direct 图元不会越界读取顶点
+    uint32_t MaxIndex(const char *binary, const AccessorView &indices)
+    {
+        uint32_t result = 0;
+        const char *p = binary + indices.offset;
+        for (size_t i = 0; i < indices.count; i++, p += indices.stride)
+            result = std::max(result, ReadIndex(p, indices.componentType));
+        return result;
+    }
+
+    // 把任意分量类型的图元转换为 Vertex + 32 位索引
+    void ConvertPrimitive(const char *binary, const AccessorView &position, const AccessorView *normal,
+                          const AccessorView *texCoord, const AccessorView *indices, GltfPrimitive &out)
+    {
+        out.vertices.resize(position.count);
+        for (size_t i = 0; i < position.count; i++)
+        {
+            Vertex &vertex = out.vertices[i];
+            const char *p = binary + position.offset + i * position.stride;
+            size_t size = ComponentSize(position.componentType);
+            for (int k = 0; k < 3; k++)
+                vertex.Position[k] = ReadComponent(p + k * size, position.componentType, position.normalized);
+
+            vertex.Normal = glm::vec3(0.0f);
+            if (normal && i < normal->count)
+            {
+                p = binary + normal->offset + i * normal->stride;
+                size = ComponentSize(normal->componentType);
+                for (int k = 0; k < 3; k++)
+                    vertex.Normal[k] = ReadComponent(p + k * size, normal->componentType, normal->normalized);
+            }
+
+            vertex.TexCoords = glm::vec2(0.0f);
+            if (texCoord && i < texCoord->count)
+            {
+                p = binary + texCoord->offset + i * texCoord->stride;
+                size = ComponentSize(texCoord->componentType);
+                for (int k = 0; k < 2; k++)
+                    vertex.TexCoords[k] = ReadComponent(p + k * size, texCoord->componentType, texCoord->normalized);
+            }
+        }
+
+        if (indices)
+        {
+            out.indices.reserve(indices->count);
+            for (size_t i = 0; i + 2 < indices->count; i += 3)
+            {
+                uint32_t tri[3];
+                for (int k = 0; k < 3; k++)
+                    tri[k] = ReadIndex(binary + indices->offset + (i + k) * indices->stride, indices->componentType);
+                // 丢弃引用越界顶点的三角形
+                if (tri[0] >= position.count || tri[1] >= position.count || tri[2] >= position.count)
+                    continue;
+                out.indices.insert(out.indices.end(), tri, tri + 3);
+            }
+        }
+        else
+        {
+            out.indices.resize(position.count / 3 * 3);
+            for (size_t i = 0; i < out.indices.size(); i++)
+                out.indices[i] = static_cast<unsigned int>(i);
+        }
+
+        // glTF 规定缺少法线时使用平面法线；这里生成带折痕角的平滑法线，硬边处效果与平面法线一致
+        if (!normal || normal->count < position.count)
+            NormalGenerator::Generate(out.vertices, out.indices, ThreadPool::Global());
+    }
+
+    bool BuildPrimitive(const GltfDocument &doc, const JsonValue &primitive, GltfPrimitive &out)
+    {
+        if (primitive.Number("mode", MODE_TRIANGLES) != MODE_TRIANGLES)
+            return false;
+        const JsonValue *attributes = primitive.Find("attributes");
+        if (!attributes)
+            return false;
+
+        AccessorView position, normal, texCoord, indices;
+        if (!doc.ResolveAccessor(IndexOf(*attributes, "POSITION"), position) || position.components != 3 ||
+            position.count == 0)
+            return false;
+        bool hasNormal = doc.ResolveAccessor(IndexOf(*attributes, "NORMAL"), normal) && normal.components == 3;
+        bool hasTexCoord = doc.ResolveAccessor(IndexOf(*attributes, "TEXCOORD_0"), texCoord) && texCoord.components == 2;
+        bool hasIndices = doc.ResolveAccessor(IndexOf(primitive, "indices"), indices) && indices.components == 1 &&
+                          (indices.componentType == COMPONENT_UNSIGNED_BYTE ||
+                           indices.componentType == COMPONENT_UNSIGNED_SHORT ||
+                           indices.componentType == COMPONENT_UNSIGNED_INT);
+
+        const JsonValue *materials = doc.json.Find("materials");
+        int materialIndex = IndexOf(primitive, "material");
+        if (materials && materialIndex >= 0 && static_cast<size_t>(materialIndex) < materials->Size())
+        {
+            const JsonValue *pbr = (*materials)[materialIndex].Find("pbrMetallicRoughness");
+            const JsonValue *factor = pbr ? pbr->Find("baseColorFactor") : nullptr;
+            if (factor && factor->Size() >= 3)
+                for (int i = 0; i < 3; i++)
+                    out.color[i] = static_cast<float>((*factor)[i].number);
+        }
+
+        size_t indexBytes = hasIndices ? ComponentSize(indices.componentType) : 0;
+        out.direct = IsFloatAttribute(position, 3) && hasNormal && IsFloatAttribute(normal, 3) &&
+                     normal.count >= position.count && (!hasTexCoord || IsFloatAttribute(texCoord, 2)) &&
+                     hasIndices && indices.stride == indexBytes && indices.offset % indexBytes == 0 &&
+                     indices.count >= 3 && MaxIndex(doc.binary, indices) < position.count;
+
+        if (out.direct)
+        {
+            out.vertexCount = position.count;
+            out.layout.positionOffset = position.offset;
+            out.layout.positionStride = static_cast<unsigned int>(position.stride);
+            out.layout.normalOffset = normal.offset;
+            out.layout.normalStride = static_cast<unsigned int>(normal.stride);
+            if (hasTexCoord && texCoord.count >= position.count)
+            {
+                out.layout.texCoordOffset = texCoord.offset;
+                out.layout.texCoordStride = static_cast<unsigned int>(texCoord.stride);
+            }
+            out.layout.indexOffset = indices.offset;
+            out.layout.indexCount = indices.count / 3 * 3;
+            out.layout.indexType = static_cast<GLenum>(indices.componentType);
+        }
+        else
+        {
+            ConvertPrimitive(doc.binary, position, hasNormal ? &normal : nullptr, hasTexCoord ? &texCoord : nullptr,
+                             hasIndices ? &indices : nullptr, out);
+            if (out.indices.empty())
+                return false;
+        }
+
+        // POSITION 的 min/max 是规范要求的字段，缺失时再扫描
+        if (position.hasBounds)
+        {
+            out.boundsMin = position.min;
+            out.boundsMax = position.max;
+        }
+        else
+        {
+            out.boundsMin = glm::vec3(INFINITY);
+            out.boundsMax = glm::vec3(-INFINITY);
+            for (size_t i = 0; i < position.count; i++)
+            {
+                glm::vec3 p;
+                const char *src = doc.binary + position.offset + i * position.stride;
+                size_t size = ComponentSize(position.componentType);
+                for (int k = 0; k < 3; k++)
+                    p[k] = ReadComponent(src + k * size, position.componentType, position.normalized);
+                out.boundsMin = glm::min(out.boundsMin, p);
+                out.boundsMax = glm::max(out.boundsMax, p);
+            }
+        }
+        return true;
+    }
+
+    bool ReadChunks(const char *data, size_t size, const char *&json, size_t &jsonSize, const char *&binary,
+                    size_t &binarySize)
+    {
+        uint32_t header[3];
+        std::memcpy(header, data, sizeof(header));
+        if (header[0] != GLB_MAGIC || header[1] != 2 || header[2] > size)
+            return false;
+
+        json = nullptr;
+        binary = nullptr;
+        size_t offset = GLB_HEADER_BYTES;
+        while (offset + CHUNK_HEADER_BYTES <= header[2])
+        {
+            uint32_t chunk[2];
+            std::memcpy(chunk, data + offset, sizeof(chunk));
+            offset += CHUNK_HEADER_BYTES;
+            if (chunk[0] > header[2] - offset)
+                return false;
+            if (chunk[1] == CHUNK_JSON && !json)
+            {
+                json = data + offset;
+                jsonSize = chunk[0];
+            }
+            else if (chunk[1] == CHUNK_BIN && !binary)
+            {
+                binary = data + offset;
+                binarySize = chunk[0];
+            }
+            // 块长度按 4 字节对齐
+            offset += (chunk[0] + 3) & ~static_cast<size_t>(3);
+        }
+        return json != nullptr;
+    }
+}
+
+bool GltfLoader::IsGlb(const char *data, size_t size)
+{
+    uint32_t magic;
+    if (size < GLB_HEADER_BYTES)
+        return false;
+    std::memcpy(&magic, data, sizeof(magic));
+    return magic == GLB_MAGIC;
+}
+
+bool GltfLoader::Load(const std::string &path, GltfModel &out, ImportProgress *progress)
+{
+    std::cout << "[GltfLoader] Loading model from: " << path << std::endl;
+    auto start = std::chrono::steady_clock::now();
+
+    if (progress)
+        progress->BeginStage("Parsing", 0.0f, 0.2f);
+    if (!out.file.Open(path) || !IsGlb(out.file.Data(), out.file.Size()))
+    {
+        std::cerr << "[GltfLoader] Not a GLB file: " << path << std::endl;
+        return false;
+    }
+
+    GltfDocument doc;
+    const char *json;
+    size_t jsonSize = 0;
+    if (!ReadChunks(out.file.Data(), out.file.Size(), json, jsonSize, doc.binary, doc.binarySize))
+    {
+        std::cerr << "[GltfLoader] Malformed GLB container: " << path << std::endl;
+        return false;
+    }
+    std::string error;
+    if (!JsonValue::Parse(json, json + jsonSize, doc.json, &error))
+    {
+        // JSON 块末尾可能以空格补齐到 4 字节，Parse 已跳过空白
+        std::cerr << "[GltfLoader] Invalid JSON chunk (" << error << "): " << path << std::endl;
+        return false;
+    }
+
+    const JsonValue *required = doc.json.Find("extensionsRequired");
+    for (size_t i = 0; required && i < required->Size(); i++)
+    {
+        const std::string &name = (*required)[i].string;
+        if (name == "KHR_draco_mesh_compression" || name == "EXT_meshopt_compression")
+        {
+            std::cerr << "[GltfLoader] Unsupported required extension " << name << ": " << path << std::endl;
+            return false;
+        }
+    }
+
+    const JsonValue *nodes = doc.json.Find("nodes");
+    const JsonValue *meshes = doc.json.Find("meshes");
+    if (!nodes || !meshes)
+    {
+        std::cerr << "[GltfLoader] No meshes in: " << path << std::endl;
+        return false;
+    }
+
+    // 根节点：默认 scene 的 nodes；没有 scene 时取所有不是子节点的节点
+    std::vector<int> roots;
+    const JsonValue *scenes = doc.json.Find("scenes");
+    size_t sceneIndex = static_cast<size_t>(doc.json.Number("scene", 0.0));
+    if (scenes && sceneIndex < scenes->Size() && (*scenes)[sceneIndex].Find("nodes"))
+    {
+        const JsonValue &sceneNodes = *(*scenes)[sceneIndex].Find("nodes");
+        for (size_t i = 0; i < sceneNodes.Size(); i++)
+            roots.push_back(static_cast<int>(sceneNodes[i].number));
+    }
+    else
+    {
+        std::vector<bool> isChild(nodes->Size(), false);
+        for (size_t i = 0; i < nodes->Size(); i++)
+        {
+            const JsonValue *children = (*nodes)[i].Find("children");
+            for (size_t k = 0; children && k < children->Size(); k++)
+            {
+                size_t child = static_cast<size_t>((*children)[k].number);
+                if (child < isChild.size())
+                    isChild[child] = true;
+            }
+        }
+        for (size_t i = 0; i < nodes->Size(); i++)
+            if (!isChild[i])
+                roots.push_back(static_cast<int>(i));
+    }
+
+    if (progress)
+        progress->BeginStage("Converting", 0.2f, 0.8f);
+
+    // 深度优先遍历节点层级，累积世界矩阵
+    struct PendingNode
+    {
+        int index;
+        glm::mat4 parent;
+        int depth;
+    };
+    std::vector<PendingNode> stack;
+    for (auto it = roots.rbegin(); it != roots.rend(); ++it)
+        stack.push_back(PendingNode{*it, glm::mat4(1.0f), 0});
+
+    size_t skipped = 0;
+    while (!stack.empty())
+    {
+        if (progress && progress->IsCancelled())
+        {
+            std::cout << "[GltfLoader] Import cancelled: " << path << std::endl;
+            return false;
+        }
+
+        PendingNode pending = stack.back();
+        stack.pop_back();
+        if (pending.index < 0 || static_cast<size_t>(pending.index) >= nodes->Size() || pending.depth > MAX_NODE_DEPTH)
+            continue;
+        const JsonValue &node = (*nodes)[pending.index];
+        glm::mat4 world = pending.parent * LocalTransform(node);
+
+        int meshIndex = IndexOf(node, "mesh");
+        if (meshIndex >= 0 && static_cast<size_t>(meshIndex) < meshes->Size())
+        {
+            const JsonValue &mesh = (*meshes)[meshIndex];
+            const JsonValue *primitives = mesh.Find("primitives");
+            std::string name = node.String("name");
+            if (name.empty())
+                name = mesh.String("name");
+            if (name.empty())
+                name = "glTF Node " + std::to_string(pending.index);
+
+            for (size_t p = 0; primitives && p < primitives->Size(); p++)
+            {
+                GltfPrimitive primitive;
+                primitive.transform = world;
+                primitive.name = primitives->Size() > 1 ? name + " [" + std::to_string(p) + "]" : name;
+                if (BuildPrimitive(doc, (*primitives)[p], primitive))
+                    out.primitives.push_back(std::move(primitive));
+                else
+                    skipped++;
+            }
+        }
+
+        const JsonValue *children = node.Find("children");
+        for (size_t k = children ? children->Size() : 0; k-- > 0;)
+            stack.push_back(PendingNode{static_cast<int>((*children)[k].number), world, pending.depth + 1});
+    }
+
+    if (out.primitives.empty())
+    {
+        std::cerr << "[GltfLoader] No supported triangle primitives in: " << path << std::endl;
+        return false;
+    }
+
+    // 只上传 direct 图元引用到的区间（通常跳过内嵌图像），布局偏移改为相对上传起点
+    size_t rangeBegin = doc.binarySize, rangeEnd = 0, directCount = 0;
+    for (const GltfPrimitive &primitive : out.primitives)
+    {
+        if (!primitive.direct)
+            continue;
+        directCount++;
+        const MeshBufferLayout &layout = primitive.layout;
+        size_t last = primitive.vertexCount - 1;
+        rangeBegin = std::min({rangeBegin, layout.positionOffset, layout.normalOffset, layout.indexOffset});
+        rangeEnd = std::max({rangeEnd, layout.positionOffset + last * layout.positionStride + sizeof(glm::vec3),
+                             layout.normalOffset + last * layout.normalStride + sizeof(glm::vec3),
+                             layout.indexOffset + layout.indexCount * ComponentSize(static_cast<int>(layout.indexType))});
+        if (layout.texCoordOffset != MeshBufferLayout::NO_ATTRIBUTE)
+        {
+            rangeBegin = std::min(rangeBegin, layout.texCoordOffset);
+            rangeEnd = std::max(rangeEnd, layout.texCoordOffset + last * layout.texCoordStride + sizeof(glm::vec2));
+        }
+    }
+    if (directCount > 0)
+    {
+        // GL 要求索引偏移按类型对齐，上传起点按 4 字节对齐即可保持所有偏移的对齐
+        rangeBegin &= ~static_cast<size_t>(3);
+        out.binary = doc.binary + rangeBegin;
+        out.binarySize = rangeEnd - rangeBegin;
+        for (GltfPrimitive &primitive : out.primitives)
+        {
+            if (!primitive.direct)
+                continue;
+            MeshBufferLayout &layout = primitive.layout;
+            layout.positionOffset -= rangeBegin;
+            layout.normalOffset -= rangeBegin;
+            layout.indexOffset -= rangeBegin;
+            if (layout.texCoordOffset != MeshBufferLayout::NO_ATTRIBUTE)
+                layout.texCoordOffset -= rangeBegin;
+        }
+    }
+
+    if (progress)
+        progress->BeginStage("Done", 1.0f, 0.0f);
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[GltfLoader] " << out.primitives.size() << " primitives (" << directCount << " zero-copy, "
+              << out.primitives.size() - directCount << " converted, " << skipped << " skipped), "
+              << out.binarySize / 1024 << " KB shared buffer in " << ms << " ms" << std::endl;
+    return true;
+}
+
+std::vector<Mesh *> GltfLoader::CreateMeshes(const GltfModel &model)
+{
+    std::vector<Mesh *> meshes;
+    meshes.reserve(model.primitives.size());
+
+    // 所有 direct 图元共用一个缓冲，数据从映射的 BIN 块直接上传
+    std::shared_ptr<SharedBuffer> buffer;
+    if (model.binary && model.binarySize > 0)
+        buffer = std::make_shared<SharedBuffer>(model.binary, model.binarySize);
+
+    for (const GltfPrimitive &primitive : model.primitives)
+    {
+        Mesh *mesh;
+        if (primitive.direct)
+        {
+            // 顶点留在共享缓冲中，使用访问器给出的范围
+            mesh = new Mesh(buffer, primitive.layout, std::vector<Texture>());
+            mesh->bounds = BoundingVolume::FromBox(primitive.boundsMin, primitive.boundsMax);
+        }
+        else
+            mesh = new Mesh(primitive.vertices.data(), primitive.vertices.size(), primitive.indices.data(),
+                            primitive.indices.size(), GL_UNSIGNED_INT,
+                            BoundingVolume::FromBox(primitive.boundsMin, primitive.boundsMax), std::vector<Texture>());
+        meshes.push_back(mesh);
+    }
+    return meshes;
+}
+
+void GltfLoader::DecomposeTransform(const glm::mat4 &transform, glm::vec3 &position, glm::vec3 &rotationDegrees,
+                                    glm::vec3 &scale)
+{
+    position = glm::vec3(transform[3]);
+    glm::vec3 axes[3] = {glm::vec3(transform[0]), glm::vec3(transform[1]), glm::vec3(transform[2])};
+    for (int i = 0; i < 3; i++)
+    {
+        scale[i] = glm::length(axes[i]);
+        axes[i] = scale[i] > 0.0f ? axes[i] / scale[i] : glm::vec3(0.0f);
+    }
+    // 镜像变换：把符号放到 X 缩放上
+    if (glm::dot(glm::cross(axes[0], axes[1]), axes[2]) < 0.0f)
+    {
+        scale.x = -scale.x;
+        axes[0] = -axes[0];
+    }
+
+    // SceneObject 的旋转矩阵为 Rx * Ry * Rz；axes[c][r] 为第 r 行第 c 列
+    float sinY = std::max(-1.0f, std::min(1.0f, axes[2][0]));
+    float x, y, z;
+    y = std::asin(sinY);
+    if (std::fabs(sinY) < 0.9999f)
+    {
+        x = std::atan2(-axes[2][1], axes[2][2]);
+        z = std::atan2(-axes[1][0], axes[0][0]);
+    }
+    else
+    {
+        // 万向节锁：Z 归零，剩余旋转全部记到 X
+        x = std::atan2(axes[0][1], axes[1][1]);
+        z = 0.0f;
+    }
+    rotationDegrees = glm::vec3(glm::degrees(x), glm::degrees(y), glm::degrees(z));
+}
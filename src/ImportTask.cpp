@@ -0,0 +1,51 @@
+#include "ImportTask.h"
+#include <iostream>
+
+ImportTask::ImportTask(const std::string &path, const ImportOptions &options, const StreamingOptions *streaming)
+    : path(path), options(options), streaming(streaming != nullptr)
+{
+    if (streaming)
+        streamingOptions = *streaming;
+
+    ModelFormat format = ModelLoader::DetectFormat(path);
+    gltf = format == ModelFormat::Gltf;
+
+    // 流式导入按 OBJ 文本分区，其他格式退回内存导入
+    if (this->streaming && format != ModelFormat::Obj)
+    {
+        std::cout << "[ImportTask] Out-of-core import supports OBJ only, loading in memory: " << path << std::endl;
+        this->streaming = false;
+    }
+
+    worker = std::thread([this]
+                         {
+        if (gltf)
+        {
+            succeeded = GltfLoader::Load(this->path, gltfModel, &progress);
+        }
+        else if (this->streaming)
+        {
+            chunkedMesh = StreamingImporter::Import(this->path, streamingOptions, &progress);
+            succeeded = chunkedMesh != nullptr;
+        }
+        else
+        {
+            succeeded = ModelLoader::LoadMeshData(this->path, data, &progress, this->options);
+        }
+        finished.store(true, std::memory_order_release); });
+}
+
+ImportTask::~ImportTask()
+{
+    Cancel();
+    if (worker.joinable())
+        worker.join();
+    delete chunkedMesh;
+}
+
+ChunkedMesh *ImportTask::TakeChunkedMesh()
+{
+    ChunkedMesh *result = chunkedMesh;
+    chunkedMesh = nullptr;
+    return result;
+}
@@ -0,0 +1,117 @@
+#include "IndexFormat.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define INDEX_FORMAT_SSE2 1
+#endif
+
+GLenum IndexFormat::Select(size_t vertexCount)
+{
+    return vertexCount <= MAX_SHORT_VERTICES ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+size_t IndexFormat::Size(GLenum type)
+{
+    switch (type)
+    {
+    case GL_UNSIGNED_BYTE:
+        return 1;
+    case GL_UNSIGNED_SHORT:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+void IndexFormat::Narrow(const unsigned int *source, size_t count, uint16_t *destination)
+{
+    size_t i = 0;
+#ifdef INDEX_FORMAT_SSE2
+    // SSE2 只有有符号饱和打包：先减去 32768 移到有符号范围，打包后再加回
+    const __m128i bias32 = _mm_set1_epi32(32768);
+    const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i lo = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i)), bias32);
+        __m128i hi = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i + 4)), bias32);
+        __m128i packed = _mm_xor_si128(_mm_packs_epi32(lo, hi), bias16);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i), packed);
+    }
+#endif
+    for (; i < count; i++)
+        destination[i] = static_cast<uint16_t>(source[i]);
+}
+
+void IndexFormat::Widen(const uint16_t *source, size_t count, unsigned int *destination)
+{
+    size_t i = 0;
+#ifdef INDEX_FORMAT_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i), _mm_unpacklo_epi16(packed, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i + 4), _mm_unpackhi_epi16(packed, zero));
+    }
+#endif
+    for (; i < count; i++)
+        destination[i] = source[i];
+}
+
+unsigned int IndexFormat::MaxIndex(const void *indices, size_t count, GLenum type)
+{
+    unsigned int result = 0;
+    size_t i = 0;
+    if (type == GL_UNSIGNED_SHORT)
+    {
+        const uint16_t *source = static_cast<const uint16_t *>(indices);
+#ifdef INDEX_FORMAT_SSE2
+        // 同 Narrow：异或 0x8000 后用有符号 max，取出时再异或回来
+        const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+        __m128i best = bias;
+        for (; i + 8 <= count; i += 8)
+            best = _mm_max_epi16(best, _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i)), bias));
+        uint16_t lanes[8];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), _mm_xor_si128(best, bias));
+        for (uint16_t lane : lanes)
+            result = result > lane ? result : lane;
+#endif
+        for (; i < count; i++)
+            result = result > source[i] ? result : source[i];
+        return result;
+    }
+
+    const unsigned int *source = static_cast<const unsigned int *>(indices);
+#ifdef INDEX_FORMAT_SSE2
+    // SSE2 没有 32 位无符号 max：异或符号位后有符号比较，再按掩码选择
+    const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    __m128i best = bias;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i value = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i)), bias);
+        __m128i greater = _mm_cmpgt_epi32(value, best);
+        best = _mm_or_si128(_mm_and_si128(greater, value), _mm_andnot_si128(greater, best));
+    }
+    unsigned int lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), _mm_xor_si128(best, bias));
+    for (unsigned int lane : lanes)
+        result = result > lane ? result : lane;
+#endif
+    for (; i < count; i++)
+        result = result > source[i] ? result : source[i];
+    return result;
+}
+
+const void *IndexFormat::Prepare(const unsigned int *source, size_t count, size_t vertexCount,
+                                 std::vector<uint16_t> &storage, GLenum &type)
+{
+    type = Select(vertexCount);
+    if (type == GL_UNSIGNED_INT)
+    {
+        storage.clear();
+        return source;
+    }
+    storage.resize(count);
+    Narrow(source, count, storage.data());
+    return storage.data();
+}
@@ -0,0 +1,343 @@
+#include "InstanceBatcher.h"
+#include "GeometryArena.h"
+#include "GLExtensions.h"
+#include "Renderer.h"
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+
+namespace PartC
+{
+    namespace
+    {
+        // 连续的同键对象：order[begin, end)，实例数据从 firstInstance 开始
+        struct Run
+        {
+            size_t begin;
+            size_t end;
+            size_t firstInstance;
+        };
+
+        // 反量化参数是逐次绘制的 uniform：压缩网格只有参数相同时才能合并到一次间接提交
+        bool SameQuantization(const Mesh *a, const Mesh *b)
+        {
+            if (a == b || (!a->IsPacked() && !b->IsPacked()))
+                return true;
+            return a->IsPacked() == b->IsPacked() && a->Quantization().offset == b->Quantization().offset &&
+                   a->Quantization().scale == b->Quantization().scale;
+        }
+
+        // 深度渲染不绑定纹理，纹理不同的对象也可以合并
+        template <typename Item>
+        bool SameTextures(const Item &a, const Item &b, bool depth)
+        {
+            return depth || (a.diffuse == b.diffuse && a.specular == b.specular);
+        }
+    }
+
+    InstanceBatcher::~InstanceBatcher()
+    {
+        if (buffer != 0)
+            glDeleteBuffers(1, &buffer);
+        if (indirectBuffer != 0)
+            glDeleteBuffers(1, &indirectBuffer);
+    }
+
+    void InstanceBatcher::Begin()
+    {
+        items.clear();
+    }
+
+    bool InstanceBatcher::Add(Mesh *mesh, int lod, const Material *material, const glm::mat4 &model,
+                              const glm::vec3 &color)
+    {
+        if (!mesh || !mesh->Arena())
+            return false;
+
+        Item item;
+        item.mesh = mesh;
+        item.lod = std::min(std::max(lod, 0), mesh->LodCount() - 1);
+        item.material = material;
+        const Material &resolved = material ? *material : mesh->material;
+        item.diffuse = resolved.Diffuse();
+        item.specular = resolved.Specular();
+        item.model = model;
+        item.color = color;
+        items.push_back(item);
+        return true;
+    }
+
+    void InstanceBatcher::Flush(Shader &shader)
+    {
+        Submit(shader, false);
+    }
+
+    void InstanceBatcher::FlushDepth(Shader &shader)
+    {
+        Submit(shader, true);
+    }
+
+    void InstanceBatcher::Submit(Shader &shader, bool depth)
+    {
+        if (items.empty())
+            return;
+        if (Renderer::multiDrawIndirect && GLExtensions::HasMultiDrawIndirect())
+        {
+            SubmitIndirect(shader, depth);
+            return;
+        }
+
+        // 按 (网格, LOD, 纹理) 排序，相同键的对象相邻
+        order.resize(items.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+                  {
+            const Item &x = items[a];
+            const Item &y = items[b];
+            if (x.mesh != y.mesh)
+                return x.mesh < y.mesh;
+            if (x.lod != y.lod)
+                return x.lod < y.lod;
+            if (x.diffuse != y.diffuse)
+                return x.diffuse < y.diffuse;
+            return x.specular < y.specular; });
+
+        std::vector<Run> runs;
+        instances.clear();
+        for (size_t begin = 0; begin < order.size();)
+        {
+            const Item &first = items[order[begin]];
+            size_t end = begin + 1;
+            while (end < order.size())
+            {
+                const Item &next = items[order[end]];
+                if (next.mesh != first.mesh || next.lod != first.lod || !SameTextures(next, first, depth))
+                    break;
+                end++;
+            }
+
+            runs.push_back(Run{begin, end, instances.size()});
+            if (end - begin >= MIN_GROUP_SIZE)
+                AppendInstances(begin, end, depth);
+            begin = end;
+        }
+        Upload();
+
+        shader.use();
+        std::vector<unsigned int> arrays;
+        for (const Run &run : runs)
+        {
+            const Item &first = items[order[run.begin]];
+            size_t count = run.end - run.begin;
+            if (count < MIN_GROUP_SIZE)
+            {
+                for (size_t i = run.begin; i < run.end; i++)
+                {
+                    const Item &item = items[order[i]];
+                    if (depth)
+                    {
+                        shader.setMat4("model", item.model);
+                        item.mesh->DrawDepth(shader, item.lod);
+                    }
+                    else
+                    {
+                        shader.setVec3("objectColor", item.color);
+                        Renderer::RenderMesh(item.mesh, shader, item.model, item.material);
+                    }
+                }
+                continue;
+            }
+
+            unsigned int array = depth ? first.mesh->DepthVertexArray() : first.mesh->VertexArray();
+            GeometryArena::BindVertexArray(array);
+            BindInstanceAttributes(run.firstInstance);
+            if (std::find(arrays.begin(), arrays.end(), array) == arrays.end())
+                arrays.push_back(array);
+
+            shader.setBool("instanced", true);
+            if (depth)
+                first.mesh->DrawDepthInstanced(shader, first.lod, static_cast<GLsizei>(count));
+            else
+                first.mesh->DrawInstanced(shader, first.lod, static_cast<GLsizei>(count), first.material);
+            shader.setBool("instanced", false);
+
+            Renderer::instancedDraws++;
+            Renderer::instancesDrawn += count;
+            if (!depth)
+                Renderer::trianglesDrawn += first.mesh->LodIndexCount(first.lod) / 3 * count;
+        }
+
+        // 关闭实例属性，避免之后的普通绘制读取实例缓冲
+        for (unsigned int array : arrays)
+        {
+            GeometryArena::BindVertexArray(array);
+            UnbindInstanceAttributes();
+        }
+    }
+
+    void InstanceBatcher::SubmitIndirect(Shader &shader, bool depth)
+    {
+        // 按 (VAO, 索引类型, 纹理, 网格, LOD) 排序：可以合并为一次提交的对象相邻，其中同网格同 LOD 的再合成一条命令
+        order.resize(items.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+                  {
+            const Item &x = items[a];
+            const Item &y = items[b];
+            if (x.mesh->VertexArray() != y.mesh->VertexArray())
+                return x.mesh->VertexArray() < y.mesh->VertexArray();
+            if (x.mesh->IndexType() != y.mesh->IndexType())
+                return x.mesh->IndexType() < y.mesh->IndexType();
+            if (x.diffuse != y.diffuse)
+                return x.diffuse < y.diffuse;
+            if (x.specular != y.specular)
+                return x.specular < y.specular;
+            if (x.mesh != y.mesh)
+                return x.mesh < y.mesh;
+            return x.lod < y.lod; });
+
+        // 提交批次：order[begin, end) 对应 commands 中从 firstCommand 起的 commandCount 条
+        struct Batch
+        {
+            size_t begin;
+            size_t firstCommand;
+            size_t commandCount;
+        };
+        std::vector<Batch> batches;
+        // 单独的 LOD0 对象在开启簇剔除时仍走 Renderer::RenderMesh，不写成间接命令
+        std::vector<uint32_t> culled;
+        instances.clear();
+        commands.clear();
+        for (size_t begin = 0; begin < order.size();)
+        {
+            const Item &first = items[order[begin]];
+            size_t end = begin + 1;
+            while (end < order.size())
+            {
+                const Item &next = items[order[end]];
+                if (next.mesh != first.mesh || next.lod != first.lod || !SameTextures(next, first, depth))
+                    break;
+                end++;
+            }
+
+            if (!depth && end - begin < MIN_GROUP_SIZE && first.lod == 0 && Renderer::clusterCulling &&
+                !first.mesh->meshlets.empty())
+            {
+                culled.insert(culled.end(), order.begin() + begin, order.begin() + end);
+                begin = end;
+                continue;
+            }
+
+            const Item *previous = batches.empty() ? nullptr : &items[order[batches.back().begin]];
+            if (!previous || previous->mesh->VertexArray() != first.mesh->VertexArray() ||
+                previous->mesh->IndexType() != first.mesh->IndexType() || !SameTextures(*previous, first, depth) ||
+                !SameQuantization(previous->mesh, first.mesh))
+                batches.push_back(Batch{begin, commands.size(), 0});
+
+            commands.push_back(first.mesh->IndirectCommand(first.lod, static_cast<GLuint>(end - begin),
+                                                           static_cast<GLuint>(instances.size())));
+            batches.back().commandCount++;
+            AppendInstances(begin, end, depth);
+            if (!depth)
+                Renderer::trianglesDrawn += first.mesh->LodIndexCount(first.lod) / 3 * (end - begin);
+            begin = end;
+        }
+        Upload();
+        UploadCommands();
+
+        shader.use();
+        shader.setBool("instanced", true);
+        std::vector<unsigned int> arrays;
+        for (const Batch &batch : batches)
+        {
+            const Item &first = items[order[batch.begin]];
+            unsigned int array = depth ? first.mesh->DepthVertexArray() : first.mesh->VertexArray();
+            GeometryArena::BindVertexArray(array);
+            if (std::find(arrays.begin(), arrays.end(), array) == arrays.end())
+            {
+                // baseInstance 已经偏移到各组的实例数据，属性从缓冲起点设置一次即可
+                BindInstanceAttributes(0);
+                arrays.push_back(array);
+            }
+            const size_t offset = batch.firstCommand * sizeof(DrawElementsIndirectCommand);
+            const GLsizei drawCount = static_cast<GLsizei>(batch.commandCount);
+            if (depth)
+                first.mesh->DrawDepthIndirect(shader, offset, drawCount);
+            else
+                first.mesh->DrawIndirect(shader, offset, drawCount, first.material);
+        }
+        shader.setBool("instanced", false);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        Renderer::indirectSubmits += batches.size();
+        Renderer::indirectCommands += commands.size();
+        Renderer::instancedDraws += commands.size();
+        Renderer::instancesDrawn += instances.size();
+
+        for (unsigned int array : arrays)
+        {
+            GeometryArena::BindVertexArray(array);
+            UnbindInstanceAttributes();
+        }
+
+        for (uint32_t index : culled)
+        {
+            const Item &item = items[index];
+            shader.setVec3("objectColor", item.color);
+            Renderer::RenderMesh(item.mesh, shader, item.model, item.material);
+        }
+    }
+
+    void InstanceBatcher::AppendInstances(size_t begin, size_t end, bool depth)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            const Item &item = items[order[i]];
+            InstanceData data;
+            data.model = item.model;
+            // 深度渲染不需要法线矩阵，省去求逆
+            data.normalMatrix = depth ? glm::mat3(1.0f) : glm::mat3(glm::transpose(glm::inverse(item.model)));
+            data.color = item.color;
+            instances.push_back(data);
+        }
+    }
+
+    void InstanceBatcher::Upload()
+    {
+        UploadStream(GL_ARRAY_BUFFER, buffer, capacity, instances.data(), instances.size() * sizeof(InstanceData));
+    }
+
+    void InstanceBatcher::UploadCommands()
+    {
+        // 间接缓冲在绘制时需保持绑定
+        UploadStream(GL_DRAW_INDIRECT_BUFFER, indirectBuffer, indirectCapacity, commands.data(),
+                     commands.size() * sizeof(DrawElementsIndirectCommand));
+    }
+
+    void InstanceBatcher::UploadStream(GLenum target, unsigned int &buffer, size_t &capacity, const void *data,
+                                       size_t bytes)
+    {
+        if (bytes == 0)
+            return;
+        if (buffer == 0)
+            glGenBuffers(1, &buffer);
+
+        // 先重新分配（孤立旧存储）再写入，避免等待上一帧仍在使用的数据
+        glBindBuffer(target, buffer);
+        if (bytes > capacity)
+            capacity = std::max(bytes, capacity * 2);
+        glBufferData(target, capacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(target, 0, bytes, data);
+    }
+
+    void InstanceBatcher::BindInstanceAttributes(size_t firstInstance)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        VertexFormat::Apply<InstanceData>(firstInstance * sizeof(InstanceData));
+    }
+
+    void InstanceBatcher::UnbindInstanceAttributes()
+    {
+        VertexFormat::Disable<InstanceData>();
+    }
+}
@@ -0,0 +1,300 @@
+#include "JsonValue.h"
+#include <charconv>
+#include <cstring>
+
+namespace
+{
+    // 嵌套深度上限，防止恶意输入耗尽栈
+    const int MAX_DEPTH = 128;
+
+    class JsonReader
+    {
+    public:
+        JsonReader(const char *begin, const char *end) : begin(begin), p(begin), end(end) {}
+
+        bool ParseDocument(JsonValue &out)
+        {
+            if (!ParseValue(out, 0))
+                return false;
+            SkipWhitespace();
+            return p == end;
+        }
+
+        size_t Position() const { return static_cast<size_t>(p - begin); }
+
+    private:
+        const char *begin;
+        const char *p;
+        const char *end;
+
+        void SkipWhitespace()
+        {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+                ++p;
+        }
+
+        bool Literal(const char *text)
+        {
+            size_t length = std::strlen(text);
+            if (static_cast<size_t>(end - p) < length || std::memcmp(p, text, length) != 0)
+                return false;
+            p += length;
+            return true;
+        }
+
+        bool ParseValue(JsonValue &out, int depth)
+        {
+            if (depth > MAX_DEPTH)
+                return false;
+            SkipWhitespace();
+            if (p >= end)
+                return false;
+
+            switch (*p)
+            {
+            case '{':
+                return ParseObject(out, depth);
+            case '[':
+                return ParseArray(out, depth);
+            case '"':
+                out.type = JsonValue::Type::String;
+                return ParseString(out.string);
+            case 't':
+                out.type = JsonValue::Type::Bool;
+                out.boolean = true;
+                return Literal("true");
+            case 'f':
+                out.type = JsonValue::Type::Bool;
+                out.boolean = false;
+                return Literal("false");
+            case 'n':
+                out.type = JsonValue::Type::Null;
+                return Literal("null");
+            default:
+            {
+                out.type = JsonValue::Type::Number;
+                auto result = std::from_chars(p, end, out.number);
+                if (result.ec != std::errc())
+                    return false;
+                p = result.ptr;
+                return true;
+            }
+            }
+        }
+
+        bool ParseObject(JsonValue &out, int depth)
+        {
+            out.type = JsonValue::Type::Object;
+            ++p;
+            SkipWhitespace();
+            if (p < end && *p == '}')
+            {
+                ++p;
+                return true;
+            }
+            while (true)
+            {
+                SkipWhitespace();
+                std::string key;
+                if (p >= end || *p != '"' || !ParseString(key))
+                    return false;
+                SkipWhitespace();
+                if (p >= end || *p != ':')
+                    return false;
+                ++p;
+                out.object.emplace_back(std::move(key), JsonValue());
+                if (!ParseValue(out.object.back().second, depth + 1))
+                    return false;
+                SkipWhitespace();
+                if (p < end && *p == ',')
+                {
+                    ++p;
+                    continue;
+                }
+                if (p < end && *p == '}')
+                {
+                    ++p;
+                    return true;
+                }
+                return false;
+            }
+        }
+
+        bool ParseArray(JsonValue &out, int depth)
+        {
+            out.type = JsonValue::Type::Array;
+            ++p;
+            SkipWhitespace();
+            if (p < end && *p == ']')
+            {
+                ++p;
+                return true;
+            }
+            while (true)
+            {
+                out.array.emplace_back();
+                if (!ParseValue(out.array.back(), depth + 1))
+                    return false;
+                SkipWhitespace();
+                if (p < end && *p == ',')
+                {
+                    ++p;
+                    continue;
+                }
+                if (p < end && *p == ']')
+                {
+                    ++p;
+                    return true;
+                }
+                return false;
+            }
+        }
+
+        bool ParseHex4(unsigned int &code)
+        {
+            if (end - p < 4)
+                return false;
+            code = 0;
+            for (int i = 0; i < 4; i++)
+            {
+                char c = *p++;
+                code <<= 4;
+                if (c >= '0' && c <= '9')
+                    code |= c - '0';
+                else if (c >= 'a' && c <= 'f')
+                    code |= c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F')
+                    code |= c - 'A' + 10;
+                else
+                    return false;
+            }
+            return true;
+        }
+
+        static void AppendUtf8(std::string &out, unsigned int code)
+        {
+            if (code < 0x80)
+                out += static_cast<char>(code);
+            else if (code < 0x800)
+            {
+                out += static_cast<char>(0xC0 | (code >> 6));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            }
+            else if (code < 0x10000)
+            {
+                out += static_cast<char>(0xE0 | (code >> 12));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            }
+            else
+            {
+                out += static_cast<char>(0xF0 | (code >> 18));
+                out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+
+        bool ParseString(std::string &out)
+        {
+            ++p; // 开头的引号
+            while (p < end)
+            {
+                // 无转义的片段整段追加
+                const char *start = p;
+                while (p < end && *p != '"' && *p != '\\')
+                    ++p;
+                out.append(start, p);
+                if (p >= end)
+                    return false;
+                if (*p == '"')
+                {
+                    ++p;
+                    return true;
+                }
+
+                ++p; // 反斜杠
+                if (p >= end)
+                    return false;
+                char c = *p++;
+                switch (c)
+                {
+                case '"':
+                case '\\':
+                case '/':
+                    out += c;
+                    break;
+                case 'b':
+                    out += '\b';
+                    break;
+                case 'f':
+                    out += '\f';
+                    break;
+                case 'n':
+                    out += '\n';
+                    break;
+                case 'r':
+                    out += '\r';
+                    break;
+                case 't':
+                    out += '\t';
+                    break;
+                case 'u':
+                {
+                    unsigned int code;
+                    if (!ParseHex4(code))
+                        return false;
+                    // UTF-16 代理对
+                    if (code >= 0xD800 && code < 0xDC00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u')
+                    {
+                        p += 2;
+                        unsigned int low;
+                        if (!ParseHex4(low) || low < 0xDC00 || low >= 0xE000)
+                            return false;
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    AppendUtf8(out, code);
+                    break;
+                }
+                default:
+                    return false;
+                }
+            }
+            return false;
+        }
+    };
+}
+
+bool JsonValue::Parse(const char *begin, const char *end, JsonValue &out, std::string *error)
+{
+    out = JsonValue();
+    JsonReader reader(begin, end);
+    if (reader.ParseDocument(out))
+        return true;
+    if (error)
+        *error = "syntax error near byte " + std::to_string(reader.Position());
+    return false;
+}
+
+const JsonValue *JsonValue::Find(const char *key) const
+{
+    if (type != Type::Object)
+        return nullptr;
+    for (const auto &member : object)
+        if (member.first == key)
+            return &member.second;
+    return nullptr;
+}
+
+double JsonValue::Number(const char *key, double fallback) const
+{
+    const JsonValue *value = Find(key);
+    return value && value->type == Type::Number ? value->number : fallback;
+}
+
+const std::string &JsonValue::String(const char *key) const
+{
+    static const std::string empty;
+    const JsonValue *value = Find(key);
+    return value && value->type == Type::String ? value->string : empty;
+}
@@ -0,0 +1,138 @@
+#include "MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+#ifdef _WIN32
+        std::swap(fileHandle, other.fileHandle);
+        std::swap(mappingHandle, other.mappingHandle);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string &path)
+{
+    Close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    data = static_cast<const char *>(view);
+    size = static_cast<size_t>(fileSize.QuadPart);
+    fileHandle = file;
+    mappingHandle = mapping;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (data)
+        UnmapViewOfFile(data);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    if (fileHandle)
+        CloseHandle(fileHandle);
+    data = nullptr;
+    size = 0;
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const std::string &path)
+{
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    // 预先建立页表，避免解析过程中逐页缺页中断
+    flags |= MAP_POPULATE;
+#endif
+    void *view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, flags, fd, 0);
+    // 映射建立后即可关闭文件描述符，映射本身仍然有效
+    close(fd);
+    if (view == MAP_FAILED)
+        return false;
+
+    // 解析是顺序扫描，提示内核加大预读
+    madvise(view, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+    data = static_cast<const char *>(view);
+    size = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (data)
+        munmap(const_cast<char *>(data), size);
+    data = nullptr;
+    size = 0;
+}
+
+#endif
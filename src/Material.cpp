@@ -0,0 +1,65 @@
+#include "Material.h"
+
+size_t Material::textureBinds = 0;
+size_t Material::bindsSkipped = 0;
+unsigned int Material::boundTextures[Material::UNIT_COUNT] = {Material::UNKNOWN_TEXTURE, Material::UNKNOWN_TEXTURE};
+
+Material::Material(const std::vector<Texture> &textures) : useTexture(!textures.empty())
+{
+    for (const Texture &texture : textures)
+    {
+        if (texture.type == "diffuse" && textureIds[UNIT_DIFFUSE] == 0)
+            textureIds[UNIT_DIFFUSE] = texture.id;
+        else if (texture.type == "specular" && textureIds[UNIT_SPECULAR] == 0)
+            textureIds[UNIT_SPECULAR] = texture.id;
+    }
+    if (textureIds[UNIT_SPECULAR] == 0)
+        textureIds[UNIT_SPECULAR] = textureIds[UNIT_DIFFUSE];
+}
+
+void Material::Bind(Shader &shader) const
+{
+    Shader::MaterialUniforms &uniforms = shader.materialUniforms;
+    if (!uniforms.resolved)
+    {
+        uniforms.useTexture = glGetUniformLocation(shader.ID, "useTexture");
+        glUniform1i(glGetUniformLocation(shader.ID, "material.diffuse"), UNIT_DIFFUSE);
+        glUniform1i(glGetUniformLocation(shader.ID, "material.specular"), UNIT_SPECULAR);
+        uniforms.resolved = true;
+    }
+
+    const int flag = useTexture ? 1 : 0;
+    if (uniforms.useTextureValue != flag)
+    {
+        glUniform1i(uniforms.useTexture, flag);
+        uniforms.useTextureValue = flag;
+    }
+    // 着色器在 useTexture 为 0 时不采样，纹理单元保持原样
+    if (!useTexture)
+        return;
+
+    bool switchedUnit = false;
+    for (unsigned int unit = 0; unit < UNIT_COUNT; unit++)
+    {
+        if (boundTextures[unit] == textureIds[unit])
+        {
+            bindsSkipped++;
+            continue;
+        }
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, textureIds[unit]);
+        boundTextures[unit] = textureIds[unit];
+        textureBinds++;
+        switchedUnit = true;
+    }
+    if (switchedUnit)
+        glActiveTexture(GL_TEXTURE0);
+}
+
+void Material::BeginFrame()
+{
+    for (unsigned int &texture : boundTextures)
+        texture = UNKNOWN_TEXTURE;
+    textureBinds = 0;
+    bindsSkipped = 0;
+}
@@ -1,87 +1,329 @@
 #include "Mesh.h"
+#include "IndexFormat.h"
+#include <algorithm>
+#include <iostream>
+#include <utility>
 
-Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures)
+Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures,
+           MeshResidency residency)
+    : vertices(std::move(vertices)), indices(std::move(indices)), textures(std::move(textures)),
+      material(this->textures)
 {
-    this->vertices = vertices;
-    this->indices = indices;
-    this->textures = textures;
+    // 只有 CPU 端数组的网格（程序生成）在这里求包围体
+    if (!this->vertices.empty())
+        bounds = BoundingVolume::FromPositions(&this->vertices[0].Position, this->vertices.size(), sizeof(Vertex));
+    setupMesh(this->vertices.data(), this->vertices.size(), this->indices.data(), this->indices.size(), GL_UNSIGNED_INT);
 
-    setupMesh();
+    if (residency == MeshResidency::ReleaseAfterUpload)
+        ReleaseCpuData();
 }
 
-void Mesh::setupMesh()
+Mesh::Mesh(const Vertex *vertexData, size_t vertexCount, const void *indexData, size_t indexCount, GLenum indexType,
+           const BoundingVolume &bounds, std::vector<Texture> textures)
+    : textures(std::move(textures)), material(this->textures), bounds(bounds)
 {
-    // [Part C] TODO: 这里是标准的 OpenGL 缓冲设置。后续如果需要实例化渲染或特殊优化，请修改此处。
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
+    setupMesh(vertexData, vertexCount, indexData, indexCount, indexType);
+}
+
+Mesh::Mesh(const PackedVertex *vertexData, size_t vertexCount, const void *indexData, size_t indexCount,
+           GLenum indexType, const VertexQuantization &quantization, const BoundingVolume &bounds,
+           std::vector<Texture> textures)
+    : textures(std::move(textures)), material(this->textures), bounds(bounds)
+{
+    this->quantization = quantization;
 
-    glBindVertexArray(VAO);
+    setupPackedMesh(vertexData, vertexCount, indexData, indexCount, indexType);
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+Mesh::Mesh(std::shared_ptr<SharedBuffer> buffer, const MeshBufferLayout &layout, std::vector<Texture> textures)
+    : textures(std::move(textures)), material(this->textures)
+{
+    sharedBuffer = std::move(buffer);
+    indexCount = static_cast<unsigned int>(layout.indexCount);
+    indexType = layout.indexType;
+    indexByteOffset = layout.indexOffset;
+    // 缓冲归 sharedBuffer 所有，析构时只删除 VAO
+    VBO = 0;
+    EBO = 0;
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+    glGenVertexArrays(1, &VAO);
+    depthVAO = VAO;
+    GeometryArena::BindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, sharedBuffer->Id());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sharedBuffer->Id());
 
-    // 顶点位置
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, layout.positionStride, (void *)layout.positionOffset);
 
-    // 顶点法线
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, Normal));
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, layout.normalStride, (void *)layout.normalOffset);
 
-    // 顶点纹理坐标
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, TexCoords));
+    // 没有纹理坐标时关闭该属性，着色器读到常量 (0, 0)
+    if (layout.texCoordOffset != MeshBufferLayout::NO_ATTRIBUTE)
+    {
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, layout.texCoordStride, (void *)layout.texCoordOffset);
+    }
+}
 
-    glBindVertexArray(0);
+Mesh::~Mesh()
+{
+    // 几何池中的网格只归还区间，VAO 与缓冲归几何池所有
+    if (arena)
+    {
+        arena->Free(arenaRange);
+        return;
+    }
+    GeometryArena::ForgetVertexArray(VAO);
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+}
+
+void Mesh::ReleaseCpuData()
+{
+    // swap 才能真正归还容量（clear 只清空元素）
+    std::vector<Vertex>().swap(vertices);
+    std::vector<unsigned int>().swap(indices);
 }
 
-void Mesh::Draw(Shader &shader)
+void Mesh::setupMesh(const Vertex *vertexData, size_t vertexCount, const void *indexData, size_t indexCount,
+                     GLenum indexType)
 {
-    unsigned int diffuseNr = 1;
-    unsigned int specularNr = 1;
+    // [新增] 顶点与索引上传到几何池的共享缓冲，VAO 由几何池按格式提供
+    setupArena(GeometryArena::FORMAT_VERTEX, vertexData, vertexCount, indexData, indexCount, indexType);
+}
 
-    if (textures.empty())
+void Mesh::setupPackedMesh(const PackedVertex *vertexData, size_t vertexCount, const void *indexData,
+                           size_t indexCount, GLenum indexType)
+{
+    packed = true;
+
+    // 属性格式（16 位位置、八面体法线、半精度 UV）由几何池的 VAO 设置
+    setupArena(GeometryArena::FORMAT_PACKED, vertexData, vertexCount, indexData, indexCount, indexType);
+}
+
+void Mesh::setupArena(GeometryArena::Format format, const void *vertexData, size_t vertexCount, const void *indexData,
+                      size_t indexCount, GLenum indexType)
+{
+    // 顶点数不超过 65536 时上传 16 位索引，索引带宽与显存减半
+    std::vector<uint16_t> narrowed;
+    if (indexType == GL_UNSIGNED_INT && IndexFormat::Select(vertexCount) == GL_UNSIGNED_SHORT)
     {
-        shader.setInt("useTexture", 0);
+        indexData = IndexFormat::Prepare(static_cast<const unsigned int *>(indexData), indexCount, vertexCount,
+                                         narrowed, indexType);
     }
-    else
+
+    GeometryArena &pool = GeometryArena::Get(format);
+    if (!pool.Allocate(vertexData, vertexCount, indexData, indexCount, IndexFormat::Size(indexType), arenaRange))
     {
-        shader.setInt("useTexture", 1);
+        std::cerr << "[Mesh] Geometry arena allocation failed (" << vertexCount << " vertices, " << indexCount
+                  << " indices)" << std::endl;
+        this->indexCount = 0;
+        return;
     }
+    arena = &pool;
+    VAO = pool.VertexArray();
+    depthVAO = pool.DepthVertexArray();
+    this->indexCount = static_cast<unsigned int>(indexCount);
+    this->indexType = indexType;
+    indexByteOffset = static_cast<size_t>(arenaRange.firstIndex) * arenaRange.indexSize;
+}
+
+SharedBuffer::SharedBuffer(const void *data, size_t bytes) : size(bytes)
+{
+    glGenBuffers(1, &id);
+    glBindBuffer(GL_ARRAY_BUFFER, id);
+    glBufferData(GL_ARRAY_BUFFER, bytes, data, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+SharedBuffer::~SharedBuffer()
+{
+    glDeleteBuffers(1, &id);
+}
+
+size_t Mesh::IndexSize() const
+{
+    return IndexFormat::Size(indexType);
+}
 
-    for (unsigned int i = 0; i < textures.size(); i++)
+unsigned int Mesh::LodIndexCount(int lod) const
+{
+    if (lods.empty())
+        return indexCount;
+    return lods[std::min(std::max(lod, 0), static_cast<int>(lods.size()) - 1)].indexCount;
+}
+
+void Mesh::BindMaterial(Shader &shader, const Material *override)
+{
+    SetQuantization(shader, packed, quantization);
+    (override ? *override : material).Bind(shader);
+}
+
+void Mesh::SetQuantization(Shader &shader, bool packed, const VertexQuantization &quantization)
+{
+    // 未压缩网格使用恒等反量化参数，着色器走同一条路径
+    // 每次绘制都会调用：位置每个程序只查询一次，值与该程序上次上传的相同时不再上传
+    Shader::QuantizationUniforms &uniforms = shader.quantizationUniforms;
+    if (!uniforms.resolved)
     {
-        glActiveTexture(GL_TEXTURE0 + i);
-        std::string number;
-        std::string name = textures[i].type;
-        if (name == "diffuse")
-            number = std::to_string(diffuseNr++);
-        else if (name == "specular")
-            number = std::to_string(specularNr++);
-
-        // [Fix] Match shader uniform names: material.diffuse, material.specular (no number for single texture)
-        if (name == "diffuse" && diffuseNr == 2)
-        {
-            shader.setInt("material.diffuse", i);
-        }
-        else if (name == "specular" && specularNr == 2)
-        {
-            shader.setInt("material.specular", i);
-        }
+        uniforms.quantized = glGetUniformLocation(shader.ID, "quantized");
+        uniforms.offset = glGetUniformLocation(shader.ID, "quantOffset");
+        uniforms.scale = glGetUniformLocation(shader.ID, "quantScale");
+        uniforms.resolved = true;
+    }
+    if (!uniforms.uploaded || uniforms.quantizedValue != packed)
+    {
+        glUniform1i(uniforms.quantized, packed ? 1 : 0);
+        uniforms.quantizedValue = packed;
+    }
+    if (!uniforms.uploaded || uniforms.offsetValue != quantization.offset)
+    {
+        glUniform3fv(uniforms.offset, 1, &quantization.offset[0]);
+        uniforms.offsetValue = quantization.offset;
+    }
+    if (!uniforms.uploaded || uniforms.scaleValue != quantization.scale)
+    {
+        glUniform3fv(uniforms.scale, 1, &quantization.scale[0]);
+        uniforms.scaleValue = quantization.scale;
+    }
+    uniforms.uploaded = true;
+}
+
+void Mesh::Draw(Shader &shader, int lod, const Material *material)
+{
+    BindMaterial(shader, material);
+
+    unsigned int count;
+    size_t offset;
+    LodRange(lod, count, offset);
+
+    // 同一几何池的网格共用 VAO，连续绘制时不再重复绑定
+    GeometryArena::BindVertexArray(VAO);
+    glDrawElementsBaseVertex(GL_TRIANGLES, count, indexType, (void *)offset, static_cast<GLint>(arenaRange.baseVertex));
+}
+
+void Mesh::DrawInstanced(Shader &shader, int lod, GLsizei instanceCount, const Material *material)
+{
+    BindMaterial(shader, material);
+
+    unsigned int count;
+    size_t offset;
+    LodRange(lod, count, offset);
+
+    GeometryArena::BindVertexArray(VAO);
+    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, count, indexType, (void *)offset, instanceCount,
+                                      static_cast<GLint>(arenaRange.baseVertex));
+}
+
+DrawElementsIndirectCommand Mesh::IndirectCommand(int lod, GLuint instanceCount, GLuint baseInstance) const
+{
+    unsigned int count;
+    size_t offset;
+    LodRange(lod, count, offset);
+
+    DrawElementsIndirectCommand command;
+    command.count = count;
+    command.instanceCount = instanceCount;
+    command.firstIndex = static_cast<GLuint>(offset / IndexSize());
+    command.baseVertex = static_cast<GLint>(arenaRange.baseVertex);
+    command.baseInstance = baseInstance;
+    return command;
+}
+
+void Mesh::DrawIndirect(Shader &shader, size_t offset, GLsizei drawCount, const Material *material)
+{
+    if (!GLExtensions::HasMultiDrawIndirect() || drawCount <= 0)
+        return;
+    BindMaterial(shader, material);
+
+    GeometryArena::BindVertexArray(VAO);
+    GLExtensions::MultiDrawElementsIndirect(GL_TRIANGLES, indexType, (const void *)offset, drawCount,
+                                            sizeof(DrawElementsIndirectCommand));
+}
+
+void Mesh::DrawDepth(Shader &shader, int lod)
+{
+    SetQuantization(shader, packed, quantization);
+
+    unsigned int count;
+    size_t offset;
+    LodRange(lod, count, offset);
+
+    GeometryArena::BindVertexArray(depthVAO);
+    glDrawElementsBaseVertex(GL_TRIANGLES, count, indexType, (void *)offset, static_cast<GLint>(arenaRange.baseVertex));
+}
 
-        // Also keep the numbered version if you plan to support array in shader later
-        // shader.setInt(("material." + name + number).c_str(), i);
+void Mesh::DrawDepthInstanced(Shader &shader, int lod, GLsizei instanceCount)
+{
+    SetQuantization(shader, packed, quantization);
+
+    unsigned int count;
+    size_t offset;
+    LodRange(lod, count, offset);
+
+    GeometryArena::BindVertexArray(depthVAO);
+    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, count, indexType, (void *)offset, instanceCount,
+                                      static_cast<GLint>(arenaRange.baseVertex));
+}
+
+void Mesh::DrawDepthIndirect(Shader &shader, size_t offset, GLsizei drawCount)
+{
+    if (!GLExtensions::HasMultiDrawIndirect() || drawCount <= 0)
+        return;
+    SetQuantization(shader, packed, quantization);
 
-        glBindTexture(GL_TEXTURE_2D, textures[i].id);
+    GeometryArena::BindVertexArray(depthVAO);
+    GLExtensions::MultiDrawElementsIndirect(GL_TRIANGLES, indexType, (const void *)offset, drawCount,
+                                            sizeof(DrawElementsIndirectCommand));
+}
+
+void Mesh::LodRange(int lod, unsigned int &count, size_t &offset) const
+{
+    count = indexCount;
+    offset = indexByteOffset;
+    if (!lods.empty())
+    {
+        const MeshLod &range = lods[std::min(std::max(lod, 0), static_cast<int>(lods.size()) - 1)];
+        count = range.indexCount;
+        offset += range.indexOffset * IndexSize();
     }
+}
 
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+unsigned int Mesh::DrawClusters(Shader &shader, const glm::vec4 *planes, const glm::vec3 &cameraLocal,
+                                unsigned int &visibleTriangles, const Material *material)
+{
+    // 可见簇在索引缓冲中相邻时合并为一段，减少提交的段数
+    clusterCounts.clear();
+    clusterOffsets.clear();
+    clusterBaseVertices.clear();
+    unsigned int visible = 0;
+    visibleTriangles = 0;
+    size_t rangeEnd = 0;
+    for (const Meshlet &meshlet : meshlets)
+    {
+        if (!MeshletBuilder::IsVisible(meshlet, planes, cameraLocal))
+            continue;
+        visible++;
+        visibleTriangles += meshlet.triangleCount;
+        GLsizei count = static_cast<GLsizei>(meshlet.triangleCount * 3);
+        if (!clusterCounts.empty() && rangeEnd == meshlet.indexOffset)
+            clusterCounts.back() += count;
+        else
+        {
+            clusterCounts.push_back(count);
+            clusterOffsets.push_back((const void *)(indexByteOffset + meshlet.indexOffset * IndexSize()));
+            clusterBaseVertices.push_back(static_cast<GLint>(arenaRange.baseVertex));
+        }
+        rangeEnd = meshlet.indexOffset + meshlet.triangleCount * 3;
+    }
+    if (clusterCounts.empty())
+        return 0;
 
-    glActiveTexture(GL_TEXTURE0);
-}
\ No newline at end of file
+    BindMaterial(shader, material);
+    GeometryArena::BindVertexArray(VAO);
+    glMultiDrawElementsBaseVertex(GL_TRIANGLES, clusterCounts.data(), indexType, clusterOffsets.data(),
+                                  static_cast<GLsizei>(clusterCounts.size()), clusterBaseVertices.data());
+    return visible;
+}
@@ -0,0 +1,388 @@
+#include "MeshCache.h"
+#include "IndexFormat.h"
+#include "MeshCodec.h"
+#include "ModelLoader.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    const char MAGIC[8] = {'M', 'E', 'S', 'H', 'B', 'I', 'N', '\0'};
+    const size_t HASH_BLOCK_SIZE = 4 * 1024 * 1024;
+    const uint64_t DATA_ALIGNMENT = 16;
+    // 顶点/索引数组经过 MeshCodec 编码
+    const uint32_t FLAG_ENCODED = 1;
+    // 索引数组为 16 位（只用于未压缩缓存；MeshCodec 解码结果总是 32 位）
+    const uint32_t FLAG_SHORT_INDICES = 2;
+
+    // .meshbin 文件头，其后依次是 LOD 表、网格簇表、顶点数组和索引数组
+    // 编码时顶点/索引区域分别是 vertexBytes / indexBytes 字节的 MeshCodec 数据
+    struct CacheHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t vertexStride;
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        uint64_t sourceHash;
+        uint64_t vertexCount;
+        uint64_t indexCount;
+        uint64_t vertexOffset;
+        uint64_t indexOffset;
+        uint64_t lodOffset;
+        uint64_t meshletOffset;
+        uint32_t lodCount;
+        uint32_t meshletCount;
+        float boundsMin[3];
+        float boundsMax[3];
+        float boundsRadius;
+        uint32_t flags;
+        uint64_t vertexBytes;
+        uint64_t indexBytes;
+    };
+
+    inline uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // count 个 elementSize 字节的元素从 offset 起是否落在文件内
+    // 用除法比较，头部中的计数再大也不会在乘法中回绕
+    inline bool RangeFits(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t fileSize)
+    {
+        return offset <= fileSize && count <= (fileSize - offset) / elementSize;
+    }
+
+    bool StatSource(const std::string &path, uint64_t &size, int64_t &time)
+    {
+        std::error_code ec;
+        size = fs::file_size(path, ec);
+        if (ec)
+            return false;
+        time = static_cast<int64_t>(fs::last_write_time(path, ec).time_since_epoch().count());
+        return !ec;
+    }
+
+    // ---------------- 64 位内容哈希 (xxHash64 风格，4 路并行累加) ----------------
+    const uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+    const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+    const uint64_t PRIME3 = 0x165667B19E3779F9ull;
+    const uint64_t PRIME4 = 0x85EBCA77C2B2AE63ull;
+    const uint64_t PRIME5 = 0x27D4EB2F165667C5ull;
+
+    inline uint64_t Rotl(uint64_t x, int r)
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    inline uint64_t Read64(const char *p)
+    {
+        uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline uint64_t Round(uint64_t acc, uint64_t input)
+    {
+        acc += input * PRIME2;
+        acc = Rotl(acc, 31);
+        return acc * PRIME1;
+    }
+
+    inline uint64_t MergeRound(uint64_t acc, uint64_t lane)
+    {
+        acc ^= Round(0, lane);
+        return acc * PRIME1 + PRIME4;
+    }
+
+    uint64_t HashBytes(const char *p, size_t size, uint64_t seed)
+    {
+        const char *end = p + size;
+        uint64_t h;
+        if (size >= 32)
+        {
+            uint64_t v1 = seed + PRIME1 + PRIME2;
+            uint64_t v2 = seed + PRIME2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - PRIME1;
+            const char *limit = end - 32;
+            do
+            {
+                v1 = Round(v1, Read64(p));
+                v2 = Round(v2, Read64(p + 8));
+                v3 = Round(v3, Read64(p + 16));
+                v4 = Round(v4, Read64(p + 24));
+                p += 32;
+            } while (p <= limit);
+            h = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+            h = MergeRound(h, v1);
+            h = MergeRound(h, v2);
+            h = MergeRound(h, v3);
+            h = MergeRound(h, v4);
+        }
+        else
+        {
+            h = seed + PRIME5;
+        }
+        h += static_cast<uint64_t>(size);
+
+        while (p + 8 <= end)
+        {
+            h ^= Round(0, Read64(p));
+            h = Rotl(h, 27) * PRIME1 + PRIME4;
+            p += 8;
+        }
+        while (p < end)
+        {
+            h ^= static_cast<unsigned char>(*p) * PRIME5;
+            h = Rotl(h, 11) * PRIME1;
+            ++p;
+        }
+
+        h ^= h >> 33;
+        h *= PRIME2;
+        h ^= h >> 29;
+        h *= PRIME3;
+        h ^= h >> 32;
+        return h;
+    }
+}
+
+std::string MeshCache::CachePath(const std::string &sourcePath)
+{
+    return sourcePath + ".meshbin";
+}
+
+uint64_t MeshCache::HashContent(const char *data, size_t size, ThreadPool &pool)
+{
+    size_t blockCount = (size + HASH_BLOCK_SIZE - 1) / HASH_BLOCK_SIZE;
+    std::vector<uint64_t> blockHashes(blockCount);
+    pool.ParallelFor(blockCount, [&](size_t i)
+                     {
+        size_t offset = i * HASH_BLOCK_SIZE;
+        size_t length = std::min(HASH_BLOCK_SIZE, size - offset);
+        blockHashes[i] = HashBytes(data + offset, length, i); });
+    return HashBytes(reinterpret_cast<const char *>(blockHashes.data()), blockHashes.size() * sizeof(uint64_t), size);
+}
+
+bool MeshCache::Load(const std::string &sourcePath, MeshData &out, ThreadPool &pool)
+{
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    if (!StatSource(sourcePath, sourceSize, sourceTime))
+        return false;
+
+    std::string cachePath = CachePath(sourcePath);
+    MappedFile cache;
+    if (!cache.Open(cachePath) || cache.Size() < sizeof(CacheHeader))
+        return false;
+
+    CacheHeader header;
+    std::memcpy(&header, cache.Data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.vertexStride != sizeof(Vertex))
+        return false;
+    const bool encoded = (header.flags & FLAG_ENCODED) != 0;
+    const bool shortIndices = !encoded && (header.flags & FLAG_SHORT_INDICES) != 0;
+    const size_t indexSize = shortIndices ? sizeof(uint16_t) : sizeof(unsigned int);
+    if (shortIndices && header.vertexCount > IndexFormat::MAX_SHORT_VERTICES)
+        return false;
+    // 损坏或截断的缓存：先逐项检查区间，之后的乘法才不会溢出
+    const uint64_t fileSize = cache.Size();
+    const bool vertexFits = encoded ? RangeFits(header.vertexOffset, header.vertexBytes, 1, fileSize)
+                                    : RangeFits(header.vertexOffset, header.vertexCount, sizeof(Vertex), fileSize);
+    const bool indexFits = encoded ? RangeFits(header.indexOffset, header.indexBytes, 1, fileSize)
+                                   : RangeFits(header.indexOffset, header.indexCount, indexSize, fileSize);
+    if (header.vertexOffset % alignof(Vertex) != 0 || header.indexOffset % indexSize != 0 || !vertexFits ||
+        !indexFits || !RangeFits(header.lodOffset, header.lodCount, sizeof(MeshLod), fileSize) ||
+        !RangeFits(header.meshletOffset, header.meshletCount, sizeof(Meshlet), fileSize))
+        return false;
+    // 压缩缓存的计数决定解码前分配的大小，须与压缩数据的长度相符
+    if (encoded && (header.vertexCount > MeshCodec::MaxVertexCount(static_cast<size_t>(header.vertexBytes), sizeof(Vertex)) ||
+                    header.indexCount > MeshCodec::MaxIndexCount(static_cast<size_t>(header.indexBytes))))
+        return false;
+    if (!encoded)
+    {
+        header.vertexBytes = header.vertexCount * sizeof(Vertex);
+        header.indexBytes = header.indexCount * indexSize;
+    }
+
+    std::vector<MeshLod> lods(header.lodCount);
+    if (header.lodCount > 0)
+        std::memcpy(lods.data(), cache.Data() + header.lodOffset, header.lodCount * sizeof(MeshLod));
+    for (const MeshLod &lod : lods)
+        if (static_cast<uint64_t>(lod.indexOffset) + lod.indexCount > header.indexCount)
+            return false;
+
+    std::vector<Meshlet> meshlets(header.meshletCount);
+    if (header.meshletCount > 0)
+        std::memcpy(meshlets.data(), cache.Data() + header.meshletOffset, header.meshletCount * sizeof(Meshlet));
+    for (const Meshlet &meshlet : meshlets)
+        if (static_cast<uint64_t>(meshlet.indexOffset) + meshlet.triangleCount * 3ull > header.indexCount)
+            return false;
+
+    if (header.sourceSize != sourceSize)
+        return false;
+
+    if (header.sourceTime != sourceTime)
+    {
+        // 大小相同但修改时间变化（touch、重新检出等）：比较内容哈希
+        MappedFile source;
+        if (!source.Open(sourcePath) || HashContent(source.Data(), source.Size(), pool) != header.sourceHash)
+            return false;
+
+        // 内容未变，更新缓存中的时间戳，下次无需再计算哈希
+        cache.Close();
+        header.sourceTime = sourceTime;
+        if (FILE *file = std::fopen(cachePath.c_str(), "r+b"))
+        {
+            std::fwrite(&header, sizeof(header), 1, file);
+            std::fclose(file);
+        }
+        if (!cache.Open(cachePath))
+            return false;
+    }
+
+    if (encoded)
+    {
+        // 压缩缓存：按段并行解码到自有数组，映射随后释放
+        auto decodeStart = std::chrono::steady_clock::now();
+        const unsigned char *base = reinterpret_cast<const unsigned char *>(cache.Data());
+        out.vertices.resize(static_cast<size_t>(header.vertexCount));
+        out.indices.resize(static_cast<size_t>(header.indexCount));
+        if (!MeshCodec::DecodeVertices(out.vertices.data(), out.vertices.size(), sizeof(Vertex),
+                                       base + header.vertexOffset, static_cast<size_t>(header.vertexBytes), &pool) ||
+            !MeshCodec::DecodeIndices(out.indices.data(), out.indices.size(), out.vertices.size(),
+                                      base + header.indexOffset, static_cast<size_t>(header.indexBytes), &pool))
+        {
+            out.vertices.clear();
+            out.indices.clear();
+            std::cerr << "[MeshCache] Corrupt encoded cache: " << cachePath << std::endl;
+            return false;
+        }
+        double decodeMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - decodeStart).count();
+        double rawBytes = static_cast<double>(header.vertexCount * sizeof(Vertex) + header.indexCount * sizeof(unsigned int));
+        std::cout << "[MeshCache] Decoded " << (header.vertexBytes + header.indexBytes) / (1024.0 * 1024.0) << " MB -> "
+                  << rawBytes / (1024.0 * 1024.0) << " MB in " << decodeMs << " ms ("
+                  << (decodeMs > 0.0 ? rawBytes / (decodeMs * 1.0e6) : 0.0) << " GB/s)" << std::endl;
+        out.UseOwnedArrays();
+    }
+    else
+    {
+        // 映射的索引直接上传，越界下标会让 GPU 读到缓冲之外，先做一次最大值归约
+        const GLenum indexType = shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        if (header.indexCount > 0 &&
+            IndexFormat::MaxIndex(cache.Data() + header.indexOffset, static_cast<size_t>(header.indexCount), indexType) >=
+                header.vertexCount)
+        {
+            std::cerr << "[MeshCache] Index out of range in cache: " << cachePath << std::endl;
+            return false;
+        }
+        out.mapping = std::move(cache);
+        out.vertexData = reinterpret_cast<const Vertex *>(out.mapping.Data() + header.vertexOffset);
+        out.vertexCount = static_cast<size_t>(header.vertexCount);
+        out.indexData = out.mapping.Data() + header.indexOffset;
+        out.indexCount = static_cast<size_t>(header.indexCount);
+        out.indexType = indexType;
+    }
+    out.lods = std::move(lods);
+    out.meshlets = std::move(meshlets);
+    out.bounds = BoundingVolume::FromBox(glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]),
+                                         glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]));
+    // 半径不会超过半对角线，超出（或为 NaN）时保留半对角线
+    if (header.boundsRadius >= 0.0f && header.boundsRadius <= out.bounds.radius)
+        out.bounds.radius = header.boundsRadius;
+    return true;
+}
+
+bool MeshCache::Save(const std::string &sourcePath, const MeshData &data, uint64_t sourceHash, bool encode)
+{
+    std::vector<unsigned char> encodedVertices, encodedIndices;
+    // 写入的索引：编码器需要 32 位；未压缩时按顶点数收窄为 16 位
+    std::vector<unsigned int> wideIndices;
+    std::vector<uint16_t> shortIndices;
+    const void *indexData = data.indexData;
+    GLenum indexType = data.indexType;
+    if (encode && indexType == GL_UNSIGNED_SHORT)
+    {
+        wideIndices.resize(data.indexCount);
+        IndexFormat::Widen(static_cast<const uint16_t *>(indexData), data.indexCount, wideIndices.data());
+        indexData = wideIndices.data();
+        indexType = GL_UNSIGNED_INT;
+    }
+    else if (!encode && indexType == GL_UNSIGNED_INT)
+    {
+        indexData = IndexFormat::Prepare(static_cast<const unsigned int *>(indexData), data.indexCount, data.vertexCount,
+                                         shortIndices, indexType);
+    }
+    if (encode)
+    {
+        encodedVertices = MeshCodec::EncodeVertices(data.vertexData, data.vertexCount, sizeof(Vertex));
+        encodedIndices = MeshCodec::EncodeIndices(static_cast<const unsigned int *>(indexData), data.indexCount);
+    }
+
+    CacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.vertexStride = sizeof(Vertex);
+    if (!StatSource(sourcePath, header.sourceSize, header.sourceTime))
+        return false;
+    header.sourceHash = sourceHash;
+    header.vertexCount = data.vertexCount;
+    header.indexCount = data.indexCount;
+    header.flags = encode ? FLAG_ENCODED : (indexType == GL_UNSIGNED_SHORT ? FLAG_SHORT_INDICES : 0);
+    header.vertexBytes = encode ? encodedVertices.size() : data.vertexCount * sizeof(Vertex);
+    header.indexBytes = encode ? encodedIndices.size() : data.indexCount * IndexFormat::Size(indexType);
+    header.lodOffset = sizeof(CacheHeader);
+    header.lodCount = static_cast<uint32_t>(data.lods.size());
+    header.meshletOffset = header.lodOffset + data.lods.size() * sizeof(MeshLod);
+    header.meshletCount = static_cast<uint32_t>(data.meshlets.size());
+    header.vertexOffset = AlignUp(header.meshletOffset + data.meshlets.size() * sizeof(Meshlet), DATA_ALIGNMENT);
+    header.indexOffset = AlignUp(header.vertexOffset + header.vertexBytes, DATA_ALIGNMENT);
+    for (int k = 0; k < 3; k++)
+    {
+        header.boundsMin[k] = data.bounds.min[k];
+        header.boundsMax[k] = data.bounds.max[k];
+    }
+    header.boundsRadius = data.bounds.radius;
+
+    std::string cachePath = CachePath(sourcePath);
+    std::string tempPath = cachePath + ".tmp";
+    FILE *file = std::fopen(tempPath.c_str(), "wb");
+    if (!file)
+        return false;
+
+    const char padding[DATA_ALIGNMENT] = {};
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && std::fwrite(data.lods.data(), sizeof(MeshLod), data.lods.size(), file) == data.lods.size();
+    ok = ok && std::fwrite(data.meshlets.data(), sizeof(Meshlet), data.meshlets.size(), file) == data.meshlets.size();
+    uint64_t tableEnd = header.meshletOffset + data.meshlets.size() * sizeof(Meshlet);
+    ok = ok && std::fwrite(padding, 1, header.vertexOffset - tableEnd, file) == header.vertexOffset - tableEnd;
+    const void *vertexBytes = encode ? static_cast<const void *>(encodedVertices.data()) : data.vertexData;
+    const void *indexBytes = encode ? static_cast<const void *>(encodedIndices.data()) : indexData;
+    ok = ok && std::fwrite(vertexBytes, 1, header.vertexBytes, file) == header.vertexBytes;
+    uint64_t vertexEnd = header.vertexOffset + header.vertexBytes;
+    ok = ok && std::fwrite(padding, 1, header.indexOffset - vertexEnd, file) == header.indexOffset - vertexEnd;
+    ok = ok && std::fwrite(indexBytes, 1, header.indexBytes, file) == header.indexBytes;
+    ok = (std::fclose(file) == 0) && ok;
+
+    std::error_code ec;
+    if (ok)
+        fs::rename(tempPath, cachePath, ec);
+    if (!ok || ec)
+    {
+        fs::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
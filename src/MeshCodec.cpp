@@ -0,0 +1,587 @@
+#include "MeshCodec.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MESH_CODEC_SSE2 1
+#endif
+
+namespace
+{
+    const size_t GROUP = 16;
+    const unsigned int INVALID = 0xFFFFFFFFu;
+
+    // 字节平面中每组 16 个值的存储方式
+    enum GroupMode
+    {
+        GROUP_ZERO = 0, // 全 0，不占数据
+        GROUP_BITS2 = 1,
+        GROUP_BITS4 = 2,
+        GROUP_RAW = 3
+    };
+
+    const size_t GROUP_BYTES[4] = {0, 4, 8, 16};
+
+    inline unsigned char ZigZag8(unsigned char delta)
+    {
+        return static_cast<unsigned char>((delta << 1) ^ (static_cast<signed char>(delta) >> 7));
+    }
+
+    inline unsigned char UnZigZag8(unsigned char value)
+    {
+        return static_cast<unsigned char>((value >> 1) ^ -(value & 1));
+    }
+
+    inline void Write32(std::vector<unsigned char> &out, uint32_t value)
+    {
+        unsigned char bytes[4];
+        std::memcpy(bytes, &value, 4);
+        out.insert(out.end(), bytes, bytes + 4);
+    }
+
+    inline void Write64At(std::vector<unsigned char> &out, size_t position, uint64_t value)
+    {
+        std::memcpy(out.data() + position, &value, 8);
+    }
+
+    // ---------------- 顶点 ----------------
+
+    void EncodeVertexBlock(const unsigned char *vertices, size_t n, size_t stride, unsigned char *last,
+                           std::vector<unsigned char> &out)
+    {
+        const size_t groups = (n + GROUP - 1) / GROUP;
+        unsigned char values[MeshCodec::VERTEX_BLOCK];
+
+        for (size_t k = 0; k < stride; k++)
+        {
+            unsigned char previous = last[k];
+            for (size_t i = 0; i < n; i++)
+            {
+                unsigned char byte = vertices[i * stride + k];
+                values[i] = ZigZag8(static_cast<unsigned char>(byte - previous));
+                previous = byte;
+            }
+            std::fill(values + n, values + groups * GROUP, 0);
+            last[k] = previous;
+
+            size_t header = out.size();
+            out.resize(out.size() + (groups + 3) / 4, 0);
+            for (size_t g = 0; g < groups; g++)
+            {
+                const unsigned char *v = values + g * GROUP;
+                unsigned char bits = 0;
+                for (size_t i = 0; i < GROUP; i++)
+                    bits |= v[i];
+                int mode = bits == 0 ? GROUP_ZERO : bits < 4 ? GROUP_BITS2 : bits < 16 ? GROUP_BITS4 : GROUP_RAW;
+                out[header + g / 4] |= static_cast<unsigned char>(mode << ((g % 4) * 2));
+
+                if (mode == GROUP_BITS2)
+                {
+                    for (size_t j = 0; j < 4; j++)
+                        out.push_back(static_cast<unsigned char>(v[j * 4] | (v[j * 4 + 1] << 2) | (v[j * 4 + 2] << 4) |
+                                                                 (v[j * 4 + 3] << 6)));
+                }
+                else if (mode == GROUP_BITS4)
+                {
+                    for (size_t j = 0; j < 8; j++)
+                        out.push_back(static_cast<unsigned char>(v[j * 2] | (v[j * 2 + 1] << 4)));
+                }
+                else if (mode == GROUP_RAW)
+                {
+                    out.insert(out.end(), v, v + GROUP);
+                }
+            }
+        }
+    }
+
+    // 解码一个字节平面：展开各组、还原 zigzag 与差分，结果写入 plane（长度为组数 * 16）
+    const unsigned char *DecodePlane(const unsigned char *p, const unsigned char *end, size_t groups,
+                                     unsigned char start, unsigned char *plane)
+    {
+        const unsigned char *header = p;
+        p += (groups + 3) / 4;
+        if (p > end)
+            return nullptr;
+
+#ifdef MESH_CODEC_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi8(1);
+        const __m128i low7 = _mm_set1_epi8(0x7F);
+        const __m128i nibble = _mm_set1_epi8(0x0F);
+        const __m128i low2 = _mm_set1_epi8(0x03);
+        const __m128i shiftMask0 = _mm_set1_epi32(0x000000FF);
+        const __m128i shiftMask2 = _mm_set1_epi32(0x0000FF00);
+        const __m128i shiftMask4 = _mm_set1_epi32(0x00FF0000);
+        const __m128i shiftMask6 = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+        __m128i carry = _mm_set1_epi8(static_cast<char>(start));
+#else
+        unsigned char carry = start;
+#endif
+
+        for (size_t g = 0; g < groups; g++)
+        {
+            int mode = (header[g / 4] >> ((g % 4) * 2)) & 3;
+            if (static_cast<size_t>(end - p) < GROUP_BYTES[mode])
+                return nullptr;
+
+#ifdef MESH_CODEC_SSE2
+            __m128i x;
+            if (mode == GROUP_ZERO)
+            {
+                x = zero;
+            }
+            else if (mode == GROUP_BITS2)
+            {
+                // 每个字节复制 4 份，再按通道取 0 / 2 / 4 / 6 位移的结果
+                int32_t word;
+                std::memcpy(&word, p, 4);
+                __m128i packed = _mm_cvtsi32_si128(word);
+                packed = _mm_unpacklo_epi8(packed, packed);
+                packed = _mm_unpacklo_epi16(packed, packed);
+                x = _mm_or_si128(_mm_or_si128(_mm_and_si128(packed, shiftMask0),
+                                              _mm_and_si128(_mm_srli_epi16(packed, 2), shiftMask2)),
+                                 _mm_or_si128(_mm_and_si128(_mm_srli_epi16(packed, 4), shiftMask4),
+                                              _mm_and_si128(_mm_srli_epi16(packed, 6), shiftMask6)));
+                x = _mm_and_si128(x, low2);
+            }
+            else if (mode == GROUP_BITS4)
+            {
+                __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p));
+                x = _mm_unpacklo_epi8(_mm_and_si128(packed, nibble), _mm_and_si128(_mm_srli_epi16(packed, 4), nibble));
+            }
+            else
+            {
+                x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            }
+            p += GROUP_BYTES[mode];
+
+            // zigzag 还原：(x >> 1) ^ -(x & 1)
+            x = _mm_xor_si128(_mm_and_si128(_mm_srli_epi16(x, 1), low7), _mm_sub_epi8(zero, _mm_and_si128(x, one)));
+            // 16 字节内的前缀和，再加上前一组的最后一个值
+            x = _mm_add_epi8(x, _mm_slli_si128(x, 1));
+            x = _mm_add_epi8(x, _mm_slli_si128(x, 2));
+            x = _mm_add_epi8(x, _mm_slli_si128(x, 4));
+            x = _mm_add_epi8(x, _mm_slli_si128(x, 8));
+            x = _mm_add_epi8(x, carry);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(plane + g * GROUP), x);
+
+            // 把第 15 个字节广播到所有通道
+            __m128i top = _mm_unpackhi_epi8(x, x);
+            top = _mm_shufflehi_epi16(top, 0xFF);
+            carry = _mm_shuffle_epi32(top, 0xFF);
+#else
+            unsigned char *v = plane + g * GROUP;
+            for (size_t j = 0; j < GROUP; j++)
+            {
+                unsigned char value;
+                if (mode == GROUP_ZERO)
+                    value = 0;
+                else if (mode == GROUP_BITS2)
+                    value = (p[j / 4] >> ((j % 4) * 2)) & 3;
+                else if (mode == GROUP_BITS4)
+                    value = (p[j / 2] >> ((j % 2) * 4)) & 15;
+                else
+                    value = p[j];
+                carry = static_cast<unsigned char>(carry + UnZigZag8(value));
+                v[j] = carry;
+            }
+            p += GROUP_BYTES[mode];
+#endif
+        }
+        return p;
+    }
+
+#ifdef MESH_CODEC_SSE2
+    // 16x16 字节转置：rows[r] 的第 c 个字节 -> rows[c] 的第 r 个字节
+    // 每轮把第 j 行与第 j+8 行交错，4 轮后得到转置
+    inline void Transpose16(__m128i rows[16])
+    {
+        for (int round = 0; round < 4; round++)
+        {
+            __m128i next[16];
+            for (int j = 0; j < 8; j++)
+            {
+                next[2 * j] = _mm_unpacklo_epi8(rows[j], rows[j + 8]);
+                next[2 * j + 1] = _mm_unpackhi_epi8(rows[j], rows[j + 8]);
+            }
+            for (int j = 0; j < 16; j++)
+                rows[j] = next[j];
+        }
+    }
+#endif
+
+    const unsigned char *DecodeVertexBlock(const unsigned char *p, const unsigned char *end, unsigned char *vertices,
+                                           size_t n, size_t stride, unsigned char *last, unsigned char *planes)
+    {
+        const size_t groups = (n + GROUP - 1) / GROUP;
+        for (size_t k = 0; k < stride; k++)
+        {
+            p = DecodePlane(p, end, groups, last[k], planes + k * MeshCodec::VERTEX_BLOCK);
+            if (!p)
+                return nullptr;
+            last[k] = planes[k * MeshCodec::VERTEX_BLOCK + n - 1];
+        }
+
+        // 字节平面转置回交错的顶点布局
+        size_t i = 0;
+#ifdef MESH_CODEC_SSE2
+        if (stride % GROUP == 0)
+        {
+            for (; i + GROUP <= n; i += GROUP)
+            {
+                for (size_t k = 0; k < stride; k += GROUP)
+                {
+                    __m128i rows[16];
+                    for (size_t r = 0; r < GROUP; r++)
+                        rows[r] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(planes + (k + r) * MeshCodec::VERTEX_BLOCK + i));
+                    Transpose16(rows);
+                    for (size_t r = 0; r < GROUP; r++)
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(vertices + (i + r) * stride + k), rows[r]);
+                }
+            }
+        }
+#endif
+        for (; i < n; i++)
+            for (size_t k = 0; k < stride; k++)
+                vertices[i * stride + k] = planes[k * MeshCodec::VERTEX_BLOCK + i];
+        return p;
+    }
+
+    // ---------------- 索引 ----------------
+
+    const size_t EDGE_FIFO = 16;
+    const size_t VERTEX_FIFO = 16;
+    // 编码中可引用的 FIFO 槽位数（其余码值有特殊含义）
+    const unsigned int EDGE_CODES = 15;   // 高 4 位 15：不共享边
+    const unsigned int VERTEX_CODES = 14; // 低 4 位 0：新顶点，1..14：顶点 FIFO，15：显式下标
+    const unsigned int CODE_NEXT = 0;
+    const unsigned int CODE_EXPLICIT = 15;
+
+    struct IndexState
+    {
+        unsigned int edges[EDGE_FIFO][2];
+        unsigned int vertices[VERTEX_FIFO];
+        size_t edgeHead = 0;
+        size_t vertexHead = 0;
+        unsigned int next = 0;
+        unsigned int last = 0;
+
+        void ResetFifos()
+        {
+            for (size_t i = 0; i < EDGE_FIFO; i++)
+                edges[i][0] = edges[i][1] = INVALID;
+            for (size_t i = 0; i < VERTEX_FIFO; i++)
+                vertices[i] = INVALID;
+            edgeHead = 0;
+            vertexHead = 0;
+        }
+
+        void PushEdge(unsigned int a, unsigned int b)
+        {
+            edges[edgeHead][0] = a;
+            edges[edgeHead][1] = b;
+            edgeHead = (edgeHead + 1) % EDGE_FIFO;
+        }
+
+        void PushVertex(unsigned int v)
+        {
+            vertices[vertexHead] = v;
+            vertexHead = (vertexHead + 1) % VERTEX_FIFO;
+        }
+
+        // 由新到旧的第 i 个槽位
+        const unsigned int *Edge(size_t i) const { return edges[(edgeHead + EDGE_FIFO - 1 - i) % EDGE_FIFO]; }
+        unsigned int Vertex(size_t i) const { return vertices[(vertexHead + VERTEX_FIFO - 1 - i) % VERTEX_FIFO]; }
+
+        // 三角形 (a, b, c) 编码 / 解码后更新 FIFO：反向边供相邻三角形匹配
+        void PushTriangle(unsigned int a, unsigned int b, unsigned int c)
+        {
+            PushEdge(b, a);
+            PushEdge(c, b);
+            PushEdge(a, c);
+        }
+    };
+
+    void WriteVarint(std::vector<unsigned char> &out, uint32_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    bool ReadVarint(const unsigned char *&p, const unsigned char *end, uint32_t &value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 35; shift += 7)
+        {
+            if (p >= end)
+                return false;
+            unsigned char byte = *p++;
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    // 顶点码：新顶点 / FIFO 命中 / 显式下标（差分 zigzag 后存入 explicitValues）
+    unsigned int EncodeVertex(IndexState &state, unsigned int v, std::vector<uint32_t> &explicitValues)
+    {
+        if (v == state.next)
+        {
+            state.next++;
+            state.PushVertex(v);
+            return CODE_NEXT;
+        }
+        for (unsigned int i = 0; i < VERTEX_CODES; i++)
+            if (state.Vertex(i) == v)
+                return i + 1;
+        // zigzag 在无符号域计算：负数左移是未定义行为
+        int32_t delta = static_cast<int32_t>(v - state.last);
+        explicitValues.push_back((static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31));
+        state.last = v;
+        state.PushVertex(v);
+        return CODE_EXPLICIT;
+    }
+
+    bool DecodeVertex(IndexState &state, unsigned int code, const unsigned char *&p, const unsigned char *end,
+                      unsigned int &v)
+    {
+        if (code == CODE_NEXT)
+        {
+            v = state.next++;
+            state.PushVertex(v);
+            return true;
+        }
+        if (code != CODE_EXPLICIT)
+        {
+            v = state.Vertex(code - 1);
+            return v != INVALID;
+        }
+        uint32_t zigzag;
+        if (!ReadVarint(p, end, zigzag))
+            return false;
+        int32_t delta = static_cast<int32_t>(zigzag >> 1) ^ -static_cast<int32_t>(zigzag & 1);
+        v = state.last + static_cast<unsigned int>(delta);
+        state.last = v;
+        state.PushVertex(v);
+        return true;
+    }
+
+    bool DecodeIndexSegment(const unsigned char *p, const unsigned char *end, unsigned int *destination,
+                            size_t triangles, size_t vertexCount, IndexState &state)
+    {
+        for (size_t t = 0; t < triangles; t++)
+        {
+            if (p >= end)
+                return false;
+            unsigned int code = *p++;
+            unsigned int edge = code >> 4;
+            unsigned int *tri = destination + t * 3;
+
+            if (edge < EDGE_CODES)
+            {
+                const unsigned int *shared = state.Edge(edge);
+                if (shared[0] == INVALID || !DecodeVertex(state, code & 15, p, end, tri[2]))
+                    return false;
+                tri[0] = shared[0];
+                tri[1] = shared[1];
+            }
+            else
+            {
+                if (p >= end)
+                    return false;
+                unsigned int codes = *p++;
+                if (!DecodeVertex(state, code & 15, p, end, tri[0]) || !DecodeVertex(state, codes >> 4, p, end, tri[1]) ||
+                    !DecodeVertex(state, codes & 15, p, end, tri[2]))
+                    return false;
+            }
+            // FIFO 中的下标都已检查过，这里只会拦下新解出的越界下标
+            if (tri[0] >= vertexCount || tri[1] >= vertexCount || tri[2] >= vertexCount)
+                return false;
+            state.PushTriangle(tri[0], tri[1], tri[2]);
+        }
+        return true;
+    }
+}
+
+std::vector<unsigned char> MeshCodec::EncodeVertices(const void *vertices, size_t count, size_t stride)
+{
+    std::vector<unsigned char> out;
+    if (stride == 0 || stride % 4 != 0 || stride > MAX_VERTEX_STRIDE)
+        return out;
+
+    const unsigned char *bytes = static_cast<const unsigned char *>(vertices);
+    const size_t segments = (count + VERTEX_SEGMENT - 1) / VERTEX_SEGMENT;
+    Write32(out, static_cast<uint32_t>(segments));
+    size_t table = out.size();
+    out.resize(out.size() + segments * 8);
+
+    unsigned char last[MAX_VERTEX_STRIDE];
+    for (size_t s = 0; s < segments; s++)
+    {
+        std::fill(last, last + stride, 0);
+        size_t end = std::min(count, (s + 1) * VERTEX_SEGMENT);
+        for (size_t i = s * VERTEX_SEGMENT; i < end; i += VERTEX_BLOCK)
+            EncodeVertexBlock(bytes + i * stride, std::min(VERTEX_BLOCK, end - i), stride, last, out);
+        Write64At(out, table + s * 8, out.size());
+    }
+    return out;
+}
+
+bool MeshCodec::DecodeVertices(void *destination, size_t count, size_t stride, const unsigned char *data, size_t size,
+                               ThreadPool *pool)
+{
+    if (stride == 0 || stride % 4 != 0 || stride > MAX_VERTEX_STRIDE || size < 4)
+        return false;
+
+    uint32_t segments;
+    std::memcpy(&segments, data, 4);
+    if (segments != (count + VERTEX_SEGMENT - 1) / VERTEX_SEGMENT || (size - 4) / 8 < segments)
+        return false;
+    std::vector<uint64_t> ends(segments);
+    if (segments > 0)
+        std::memcpy(ends.data(), data + 4, segments * 8);
+    const size_t tableEnd = 4 + segments * 8;
+
+    std::vector<unsigned char> ok(segments, 0);
+    auto decodeSegment = [&](size_t s)
+    {
+        uint64_t begin = s == 0 ? tableEnd : ends[s - 1];
+        if (begin > ends[s] || ends[s] > size)
+            return;
+        const unsigned char *p = data + begin;
+        const unsigned char *end = data + ends[s];
+
+        std::vector<unsigned char> planes(stride * VERTEX_BLOCK);
+        unsigned char last[MAX_VERTEX_STRIDE] = {};
+        unsigned char *out = static_cast<unsigned char *>(destination);
+        size_t segmentEnd = std::min(count, (s + 1) * VERTEX_SEGMENT);
+        for (size_t i = s * VERTEX_SEGMENT; i < segmentEnd; i += VERTEX_BLOCK)
+        {
+            p = DecodeVertexBlock(p, end, out + i * stride, std::min(VERTEX_BLOCK, segmentEnd - i), stride, last,
+                                  planes.data());
+            if (!p)
+                return;
+        }
+        ok[s] = p == end;
+    };
+
+    if (pool && segments > 1)
+        pool->ParallelFor(segments, decodeSegment);
+    else
+        for (size_t s = 0; s < segments; s++)
+            decodeSegment(s);
+    return std::find(ok.begin(), ok.end(), 0) == ok.end();
+}
+
+std::vector<unsigned char> MeshCodec::EncodeIndices(const unsigned int *indices, size_t count)
+{
+    std::vector<unsigned char> out;
+    const size_t triangles = count / 3;
+    const size_t segments = (triangles + INDEX_SEGMENT - 1) / INDEX_SEGMENT;
+    Write32(out, static_cast<uint32_t>(segments));
+    size_t table = out.size();
+    // 每段：结束偏移 (u64)、起始 next (u32)、起始 last (u32)
+    out.resize(out.size() + segments * 16);
+
+    IndexState state;
+    std::vector<uint32_t> explicitValues;
+    for (size_t s = 0; s < segments; s++)
+    {
+        state.ResetFifos();
+        std::memcpy(out.data() + table + s * 16 + 8, &state.next, 4);
+        std::memcpy(out.data() + table + s * 16 + 12, &state.last, 4);
+
+        size_t end = std::min(triangles, (s + 1) * INDEX_SEGMENT);
+        for (size_t t = s * INDEX_SEGMENT; t < end; t++)
+        {
+            const unsigned int *tri = indices + t * 3;
+            explicitValues.clear();
+
+            // 查找与 FIFO 中某条边重合的轮换
+            unsigned int edge = EDGE_CODES;
+            int rotation = 0;
+            for (unsigned int i = 0; i < EDGE_CODES && edge == EDGE_CODES; i++)
+            {
+                const unsigned int *shared = state.Edge(i);
+                for (int r = 0; r < 3; r++)
+                {
+                    if (shared[0] == tri[r] && shared[1] == tri[(r + 1) % 3])
+                    {
+                        edge = i;
+                        rotation = r;
+                        break;
+                    }
+                }
+            }
+
+            unsigned int a = tri[rotation], b = tri[(rotation + 1) % 3], c = tri[(rotation + 2) % 3];
+            if (edge < EDGE_CODES)
+            {
+                unsigned int code = EncodeVertex(state, c, explicitValues);
+                out.push_back(static_cast<unsigned char>((edge << 4) | code));
+            }
+            else
+            {
+                unsigned int codeA = EncodeVertex(state, a, explicitValues);
+                unsigned int codeB = EncodeVertex(state, b, explicitValues);
+                unsigned int codeC = EncodeVertex(state, c, explicitValues);
+                out.push_back(static_cast<unsigned char>((EDGE_CODES << 4) | codeA));
+                out.push_back(static_cast<unsigned char>((codeB << 4) | codeC));
+            }
+            for (uint32_t value : explicitValues)
+                WriteVarint(out, value);
+            state.PushTriangle(a, b, c);
+        }
+        Write64At(out, table + s * 16, out.size());
+    }
+    return out;
+}
+
+bool MeshCodec::DecodeIndices(unsigned int *destination, size_t count, size_t vertexCount, const unsigned char *data,
+                              size_t size, ThreadPool *pool)
+{
+    if (size < 4 || count % 3 != 0)
+        return false;
+    const size_t triangles = count / 3;
+
+    uint32_t segments;
+    std::memcpy(&segments, data, 4);
+    if (segments != (triangles + INDEX_SEGMENT - 1) / INDEX_SEGMENT || (size - 4) / 16 < segments)
+        return false;
+    const size_t tableEnd = 4 + static_cast<size_t>(segments) * 16;
+
+    std::vector<unsigned char> ok(segments, 0);
+    auto decodeSegment = [&](size_t s)
+    {
+        uint64_t begin = tableEnd, end;
+        if (s > 0)
+            std::memcpy(&begin, data + 4 + (s - 1) * 16, 8);
+        std::memcpy(&end, data + 4 + s * 16, 8);
+        if (begin > end || end > size)
+            return;
+
+        IndexState state;
+        state.ResetFifos();
+        std::memcpy(&state.next, data + 4 + s * 16 + 8, 4);
+        std::memcpy(&state.last, data + 4 + s * 16 + 12, 4);
+        size_t first = s * INDEX_SEGMENT;
+        size_t segmentTriangles = std::min(triangles, first + INDEX_SEGMENT) - first;
+        ok[s] = DecodeIndexSegment(data + begin, data + end, destination + first * 3, segmentTriangles, vertexCount,
+                                   state);
+    };
+
+    if (pool && segments > 1)
+        pool->ParallelFor(segments, decodeSegment);
+    else
+        for (size_t s = 0; s < segments; s++)
+            decodeSegment(s);
+    return std::find(ok.begin(), ok.end(), 0) == ok.end();
+}
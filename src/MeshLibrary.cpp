@@ -0,0 +1,70 @@
+#include "MeshLibrary.h"
+#include "GeometryUtils.h"
+#include <filesystem>
+#include <system_error>
+
+std::unordered_map<std::string, std::weak_ptr<Mesh>> MeshLibrary::entries;
+
+MeshHandle MeshLibrary::Acquire(const std::string &key, const std::function<Mesh *()> &create)
+{
+    if (MeshHandle existing = Find(key))
+        return existing;
+
+    MeshHandle mesh(create());
+    if (mesh)
+        entries[key] = mesh;
+    return mesh;
+}
+
+MeshHandle MeshLibrary::Find(const std::string &key)
+{
+    auto it = entries.find(key);
+    if (it == entries.end())
+        return nullptr;
+    MeshHandle mesh = it->second.lock();
+    if (!mesh)
+        entries.erase(it);
+    return mesh;
+}
+
+MeshHandle MeshLibrary::Cube()
+{
+    return Acquire("cube", []()
+                   { return GeometryUtils::CreateCube(); });
+}
+
+MeshHandle MeshLibrary::Sphere(int latitudeSegments, int longitudeSegments)
+{
+    std::string key = "sphere:" + std::to_string(latitudeSegments) + "x" + std::to_string(longitudeSegments);
+    return Acquire(key, [=]()
+                   { return GeometryUtils::CreateSphere(latitudeSegments, longitudeSegments); });
+}
+
+std::string MeshLibrary::FileKey(const std::string &path, bool packed, const std::string &version)
+{
+    return (packed ? "file-packed:" : "file:") + version + ":" + path;
+}
+
+std::string MeshLibrary::FileVersion(const std::string &path)
+{
+    std::error_code ec;
+    uintmax_t size = std::filesystem::file_size(path, ec);
+    if (ec)
+        return std::string();
+    auto time = std::filesystem::last_write_time(path, ec);
+    if (ec)
+        return std::string();
+    return std::to_string(size) + "@" + std::to_string(time.time_since_epoch().count());
+}
+
+size_t MeshLibrary::LiveCount()
+{
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        if (it->second.expired())
+            it = entries.erase(it);
+        else
+            ++it;
+    }
+    return entries.size();
+}
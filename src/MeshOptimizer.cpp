@@ -0,0 +1,274 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+namespace
+{
+    const unsigned int INVALID_INDEX = 0xFFFFFFFFu;
+
+    // 带时间戳的 FIFO 缓存：顶点在最近 cacheSize 次未命中之内被载入即视为命中
+    // 未命中时写入时间戳并返回 true
+    inline bool CacheMiss(std::vector<unsigned int> &cacheTime, unsigned int &timestamp, unsigned int v,
+                          unsigned int cacheSize)
+    {
+        if (timestamp - cacheTime[v] > cacheSize)
+        {
+            cacheTime[v] = timestamp++;
+            return true;
+        }
+        return false;
+    }
+}
+
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const unsigned int *indices, size_t indexCount, size_t vertexCount,
+                                                    unsigned int cacheSize)
+{
+    VertexCacheStats stats;
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0 || vertexCount == 0)
+        return stats;
+
+    std::vector<unsigned int> cacheTime(vertexCount, 0);
+    unsigned int timestamp = cacheSize + 1;
+    for (size_t i = 0; i < triangleCount * 3; i++)
+        if (CacheMiss(cacheTime, timestamp, indices[i], cacheSize))
+            stats.misses++;
+
+    stats.acmr = static_cast<float>(stats.misses) / static_cast<float>(triangleCount);
+    stats.atvr = static_cast<float>(stats.misses) / static_cast<float>(vertexCount);
+    return stats;
+}
+
+void MeshOptimizer::OptimizeVertexCache(unsigned int *destination, const unsigned int *indices, size_t indexCount,
+                                        size_t vertexCount, unsigned int cacheSize, std::vector<unsigned int> *clusters)
+{
+    const size_t triangleCount = indexCount / 3;
+    if (clusters)
+        clusters->clear();
+    if (triangleCount == 0)
+        return;
+
+    // 顶点 -> 三角形邻接表（压缩存储：offsets + adjacency）
+    std::vector<unsigned int> liveCount(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++)
+        liveCount[indices[i]]++;
+
+    std::vector<unsigned int> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++)
+        offsets[v + 1] = offsets[v] + liveCount[v];
+
+    std::vector<unsigned int> adjacency(triangleCount * 3);
+    std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++)
+        for (int k = 0; k < 3; k++)
+            adjacency[fill[indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+
+    std::vector<unsigned int> cacheTime(vertexCount, 0);
+    std::vector<unsigned char> emitted(triangleCount, 0);
+    std::vector<unsigned int> deadEnd;
+    std::vector<unsigned int> candidates;
+    deadEnd.reserve(triangleCount * 3);
+
+    unsigned int timestamp = cacheSize + 1;
+    size_t cursor = 0;
+    size_t output = 0;
+    bool newCluster = true;
+    int64_t fan = indices[0];
+
+    while (fan >= 0)
+    {
+        // 输出扇心顶点周围所有未输出的三角形
+        candidates.clear();
+        for (unsigned int j = offsets[fan]; j < offsets[fan + 1]; j++)
+        {
+            unsigned int t = adjacency[j];
+            if (emitted[t])
+                continue;
+            if (newCluster && clusters)
+                clusters->push_back(static_cast<unsigned int>(output));
+            newCluster = false;
+
+            for (int k = 0; k < 3; k++)
+            {
+                unsigned int v = indices[t * 3 + k];
+                destination[output * 3 + k] = v;
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                liveCount[v]--;
+                CacheMiss(cacheTime, timestamp, v, cacheSize);
+            }
+            emitted[t] = 1;
+            output++;
+        }
+
+        // 下一个扇心：优先选择在剩余三角形输出后仍留在缓存中、且最早进入缓存的顶点
+        fan = -1;
+        int64_t bestPriority = -1;
+        for (unsigned int v : candidates)
+        {
+            if (liveCount[v] == 0)
+                continue;
+            int64_t priority = 0;
+            if (timestamp - cacheTime[v] + 2 * liveCount[v] <= cacheSize)
+                priority = timestamp - cacheTime[v];
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                fan = v;
+            }
+        }
+
+        // 死胡同：先回溯最近输出的顶点，再按序号扫描；此处是缓存不连续的硬边界
+        if (fan < 0)
+        {
+            newCluster = true;
+            while (fan < 0 && !deadEnd.empty())
+            {
+                unsigned int v = deadEnd.back();
+                deadEnd.pop_back();
+                if (liveCount[v] > 0)
+                    fan = v;
+            }
+            while (fan < 0 && cursor < vertexCount)
+            {
+                if (liveCount[cursor] > 0)
+                    fan = static_cast<int64_t>(cursor);
+                cursor++;
+            }
+        }
+    }
+}
+
+void MeshOptimizer::OptimizeOverdraw(unsigned int *indices, size_t indexCount, const Vertex *vertices, size_t vertexCount,
+                                     const std::vector<unsigned int> &clusters, float threshold, unsigned int cacheSize)
+{
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0 || clusters.empty())
+        return;
+
+    // 1. 在硬边界内切出软边界：子簇的局部 ACMR 降到全局水平附近时切断
+    //    每个子簇从空缓存开始，单独绘制时的缓存效率与整体相当
+    float clusterThreshold = threshold * AnalyzeVertexCache(indices, indexCount, vertexCount, cacheSize).acmr;
+    std::vector<unsigned int> cacheTime(vertexCount, 0);
+    unsigned int timestamp = cacheSize + 1;
+    std::vector<unsigned int> boundaries;
+    for (size_t c = 0; c < clusters.size(); c++)
+    {
+        size_t start = clusters[c];
+        size_t end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+        timestamp += cacheSize + 1;
+        size_t misses = 0;
+        size_t clusterStart = start;
+        boundaries.push_back(static_cast<unsigned int>(start));
+        for (size_t t = start; t < end; t++)
+        {
+            for (int k = 0; k < 3; k++)
+                if (CacheMiss(cacheTime, timestamp, indices[t * 3 + k], cacheSize))
+                    misses++;
+            if (t + 1 < end && static_cast<float>(misses) <= clusterThreshold * static_cast<float>(t + 1 - clusterStart))
+            {
+                boundaries.push_back(static_cast<unsigned int>(t + 1));
+                timestamp += cacheSize + 1;
+                misses = 0;
+                clusterStart = t + 1;
+            }
+        }
+    }
+    boundaries.push_back(static_cast<unsigned int>(triangleCount));
+    const size_t clusterCount = boundaries.size() - 1;
+
+    // 2. 面积加权的簇重心与平均法线
+    glm::vec3 meshCenter(0.0f);
+    float meshArea = 0.0f;
+    std::vector<glm::vec3> clusterCenter(clusterCount);
+    std::vector<glm::vec3> clusterNormal(clusterCount);
+    for (size_t c = 0; c < clusterCount; c++)
+    {
+        glm::vec3 center(0.0f), normal(0.0f), average(0.0f);
+        float area = 0.0f;
+        for (size_t t = boundaries[c]; t < boundaries[c + 1]; t++)
+        {
+            const glm::vec3 &p0 = vertices[indices[t * 3 + 0]].Position;
+            const glm::vec3 &p1 = vertices[indices[t * 3 + 1]].Position;
+            const glm::vec3 &p2 = vertices[indices[t * 3 + 2]].Position;
+            glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+            float a = glm::length(n);
+            glm::vec3 centroid = (p0 + p1 + p2) / 3.0f;
+            center += centroid * a;
+            average += centroid;
+            normal += n;
+            area += a;
+        }
+        size_t count = boundaries[c + 1] - boundaries[c];
+        clusterCenter[c] = area > 0.0f ? center / area : average / static_cast<float>(count);
+        float len = glm::length(normal);
+        clusterNormal[c] = len > 0.0f ? normal / len : glm::vec3(0.0f);
+        meshCenter += center;
+        meshArea += area;
+    }
+    if (meshArea > 0.0f)
+        meshCenter /= meshArea;
+
+    // 3. 朝外的簇先画，能遮挡后面大部分朝内的表面
+    std::vector<std::pair<float, unsigned int>> order(clusterCount);
+    for (size_t c = 0; c < clusterCount; c++)
+        order[c] = {glm::dot(clusterCenter[c] - meshCenter, clusterNormal[c]), static_cast<unsigned int>(c)};
+    std::stable_sort(order.begin(), order.end(), [](const std::pair<float, unsigned int> &a, const std::pair<float, unsigned int> &b)
+                     { return a.first > b.first; });
+
+    std::vector<unsigned int> source(indices, indices + triangleCount * 3);
+    size_t output = 0;
+    for (const auto &entry : order)
+    {
+        size_t begin = boundaries[entry.second] * 3;
+        size_t end = boundaries[entry.second + 1] * 3;
+        std::copy(source.begin() + begin, source.begin() + end, indices + output);
+        output += end - begin;
+    }
+}
+
+void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex> &vertices, unsigned int *indices, size_t indexCount)
+{
+    std::vector<unsigned int> remap(vertices.size(), INVALID_INDEX);
+    unsigned int next = 0;
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        unsigned int &slot = remap[indices[i]];
+        if (slot == INVALID_INDEX)
+            slot = next++;
+        indices[i] = slot;
+    }
+
+    std::vector<Vertex> reordered(next);
+    for (size_t v = 0; v < vertices.size(); v++)
+        if (remap[v] != INVALID_INDEX)
+            reordered[remap[v]] = vertices[v];
+    vertices.swap(reordered);
+}
+
+void MeshOptimizer::Optimize(std::vector<Vertex> &vertices, std::vector<unsigned int> &indices, bool verbose)
+{
+    indices.resize(indices.size() / 3 * 3);
+    if (indices.empty())
+        return;
+
+    auto start = std::chrono::steady_clock::now();
+    VertexCacheStats before = AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+    std::vector<unsigned int> reordered(indices.size());
+    std::vector<unsigned int> clusters;
+    OptimizeVertexCache(reordered.data(), indices.data(), indices.size(), vertices.size(), CACHE_SIZE, &clusters);
+    OptimizeOverdraw(reordered.data(), reordered.size(), vertices.data(), vertices.size(), clusters);
+    indices.swap(reordered);
+    OptimizeVertexFetch(vertices, indices.data(), indices.size());
+
+    if (!verbose)
+        return;
+    VertexCacheStats after = AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[MeshOptimizer] ACMR " << before.acmr << " -> " << after.acmr << ", ATVR " << before.atvr
+              << " -> " << after.atvr << " (cache " << CACHE_SIZE << ", " << clusters.size()
+              << " clusters) in " << ms << " ms" << std::endl;
+}
@@ -0,0 +1,352 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include "TripletHashMap.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+
+namespace
+{
+    // 对称 4x4 矩阵的上三角部分 + 累计面积权重
+    struct Quadric
+    {
+        float a00, a01, a02, a03;
+        float a11, a12, a13;
+        float a22, a23;
+        float a33;
+        float weight;
+    };
+
+    // 平面 n·p + d = 0，按面积加权
+    void AddPlane(Quadric &q, const glm::vec3 &n, float d, float w)
+    {
+        q.a00 += w * n.x * n.x;
+        q.a01 += w * n.x * n.y;
+        q.a02 += w * n.x * n.z;
+        q.a03 += w * n.x * d;
+        q.a11 += w * n.y * n.y;
+        q.a12 += w * n.y * n.z;
+        q.a13 += w * n.y * d;
+        q.a22 += w * n.z * n.z;
+        q.a23 += w * n.z * d;
+        q.a33 += w * d * d;
+        q.weight += w;
+    }
+
+    void AddQuadric(Quadric &q, const Quadric &r)
+    {
+        q.a00 += r.a00;
+        q.a01 += r.a01;
+        q.a02 += r.a02;
+        q.a03 += r.a03;
+        q.a11 += r.a11;
+        q.a12 += r.a12;
+        q.a13 += r.a13;
+        q.a22 += r.a22;
+        q.a23 += r.a23;
+        q.a33 += r.a33;
+        q.weight += r.weight;
+    }
+
+    // 点到所有平面的加权距离平方和
+    float Evaluate(const Quadric &q, const glm::vec3 &p)
+    {
+        float x = p.x, y = p.y, z = p.z;
+        float r = q.a00 * x * x + q.a11 * y * y + q.a22 * z * z + q.a33;
+        r += 2.0f * (q.a01 * x * y + q.a02 * x * z + q.a12 * y * z);
+        r += 2.0f * (q.a03 * x + q.a13 * y + q.a23 * z);
+        return std::fabs(r);
+    }
+
+    // 半边折叠：把 v 移到 target 上
+    struct Collapse
+    {
+        unsigned int v;
+        unsigned int target;
+        float cost;
+    };
+
+    const unsigned int INVALID_COLLAPSE = 0xFFFFFFFFu;
+
+    inline uint32_t FloatBits(float f)
+    {
+        // 加 0 把 -0.0 规整为 +0.0，避免相同位置被当作不同位置
+        f += 0.0f;
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        return bits;
+    }
+}
+
+size_t MeshSimplifier::Simplify(unsigned int *destination, const unsigned int *indices, size_t indexCount,
+                                const Vertex *vertices, size_t vertexCount, size_t targetIndexCount,
+                                float targetError, float *resultError)
+{
+    std::vector<unsigned int> current(indices, indices + indexCount / 3 * 3);
+    if (resultError)
+        *resultError = 0.0f;
+    if (current.size() <= targetIndexCount || vertexCount == 0)
+    {
+        std::copy(current.begin(), current.end(), destination);
+        return current.size();
+    }
+
+    // 坐标归一化到包围盒中心、对角线长度为 1，误差直接是相对值
+    glm::vec3 lo = vertices[0].Position, hi = lo;
+    for (size_t v = 1; v < vertexCount; v++)
+    {
+        lo = glm::min(lo, vertices[v].Position);
+        hi = glm::max(hi, vertices[v].Position);
+    }
+    float diagonal = glm::length(hi - lo);
+    float invScale = diagonal > 0.0f ? 1.0f / diagonal : 1.0f;
+    glm::vec3 center = (lo + hi) * 0.5f;
+    std::vector<glm::vec3> positions(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++)
+        positions[v] = (vertices[v].Position - center) * invScale;
+
+    // 1. 位置相同的顶点归为一类（类的代表为第一个顶点）
+    std::vector<unsigned int> positionClass(vertexCount);
+    std::vector<unsigned int> classSize(vertexCount, 0);
+    {
+        TripletHashMap positionMap(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++)
+        {
+            const glm::vec3 &p = vertices[v].Position;
+            unsigned int cls = positionMap.FindOrInsert(FloatBits(p.x), FloatBits(p.y), FloatBits(p.z),
+                                                        static_cast<unsigned int>(v));
+            positionClass[v] = cls;
+            classSize[cls]++;
+        }
+    }
+
+    // 2. 锁定接缝（一个位置多个顶点）、开放边界与非流形边上的顶点
+    std::vector<unsigned char> lockedClass(vertexCount, 0);
+    {
+        std::vector<uint64_t> edges;
+        edges.reserve(current.size());
+        for (size_t i = 0; i < current.size(); i += 3)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                uint64_t a = positionClass[current[i + k]];
+                uint64_t b = positionClass[current[i + (k + 1) % 3]];
+                if (a != b)
+                    edges.push_back(a < b ? (a << 32) | b : (b << 32) | a);
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        for (size_t i = 0; i < edges.size();)
+        {
+            size_t j = i + 1;
+            while (j < edges.size() && edges[j] == edges[i])
+                j++;
+            if (j - i != 2)
+            {
+                lockedClass[edges[i] >> 32] = 1;
+                lockedClass[edges[i] & 0xFFFFFFFFu] = 1;
+            }
+            i = j;
+        }
+    }
+    std::vector<unsigned char> locked(vertexCount, 0);
+    for (size_t v = 0; v < vertexCount; v++)
+        locked[v] = classSize[positionClass[v]] > 1 || lockedClass[positionClass[v]];
+
+    // 3. 每个位置累加相邻三角形平面的二次型
+    std::vector<Quadric> quadrics(vertexCount, Quadric{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0});
+    for (size_t i = 0; i < current.size(); i += 3)
+    {
+        const glm::vec3 &p0 = positions[current[i]];
+        const glm::vec3 &p1 = positions[current[i + 1]];
+        const glm::vec3 &p2 = positions[current[i + 2]];
+        glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+        float len = glm::length(n);
+        if (len <= 0.0f)
+            continue;
+        n /= len;
+        float d = -glm::dot(n, p0);
+        for (int k = 0; k < 3; k++)
+            AddPlane(quadrics[positionClass[current[i + k]]], n, d, len * 0.5f);
+    }
+
+    // 4. 逐轮折叠：每轮按代价排序，同一顶点在一轮内最多参与一次折叠
+    const float maxCost = targetError * targetError;
+    float maxAccepted = 0.0f;
+    std::vector<Collapse> collapses;
+    std::vector<unsigned int> bestCollapse(vertexCount);
+    std::vector<unsigned int> remap(vertexCount);
+    std::iota(remap.begin(), remap.end(), 0u);
+    std::vector<unsigned char> touched(vertexCount);
+    std::vector<unsigned int> adjacencyOffsets(vertexCount + 1);
+    std::vector<unsigned int> adjacency;
+
+    while (current.size() > targetIndexCount)
+    {
+        const size_t triangleCount = current.size() / 3;
+
+        // 流形内部边在相邻两个三角形中方向相反，每条有向半边只考虑起点折叠到终点
+        // 一个顶点每轮最多折叠一次，只保留它代价最小的候选
+        collapses.clear();
+        std::fill(bestCollapse.begin(), bestCollapse.end(), INVALID_COLLAPSE);
+        for (size_t i = 0; i < current.size(); i += 3)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                unsigned int a = current[i + k];
+                unsigned int b = current[i + (k + 1) % 3];
+                if (locked[a] || a == b)
+                    continue;
+                const Quadric &qa = quadrics[positionClass[a]];
+                const Quadric &qb = quadrics[positionClass[b]];
+                float weight = std::max(qa.weight + qb.weight, 1e-20f);
+                float cost = (Evaluate(qa, positions[b]) + Evaluate(qb, positions[b])) / weight;
+                if (cost > maxCost)
+                    continue;
+                if (bestCollapse[a] == INVALID_COLLAPSE)
+                {
+                    bestCollapse[a] = static_cast<unsigned int>(collapses.size());
+                    collapses.push_back(Collapse{a, b, cost});
+                }
+                else if (cost < collapses[bestCollapse[a]].cost)
+                {
+                    collapses[bestCollapse[a]] = Collapse{a, b, cost};
+                }
+            }
+        }
+        if (collapses.empty())
+            break;
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse &x, const Collapse &y)
+                  { return x.cost < y.cost; });
+
+        // 顶点 -> 三角形邻接，用于翻转检测
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0u);
+        for (unsigned int v : current)
+            adjacencyOffsets[v + 1]++;
+        for (size_t v = 0; v < vertexCount; v++)
+            adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+        adjacency.resize(current.size());
+        {
+            std::vector<unsigned int> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < current.size(); i++)
+                adjacency[fill[current[i]]++] = static_cast<unsigned int>(i / 3);
+        }
+
+        std::fill(touched.begin(), touched.end(), 0);
+        const size_t trianglesToRemove = (current.size() - targetIndexCount) / 3 + 1;
+        size_t removed = 0;
+        size_t applied = 0;
+        for (const Collapse &c : collapses)
+        {
+            if (removed >= trianglesToRemove)
+                break;
+            if (touched[c.v] || touched[c.target])
+                continue;
+
+            // 折叠后任一相邻三角形法线反向则放弃
+            bool flips = false;
+            size_t shared = 0;
+            for (unsigned int j = adjacencyOffsets[c.v]; j < adjacencyOffsets[c.v + 1] && !flips; j++)
+            {
+                const unsigned int *tri = &current[adjacency[j] * 3];
+                if (tri[0] == c.target || tri[1] == c.target || tri[2] == c.target)
+                {
+                    shared++;
+                    continue;
+                }
+                glm::vec3 p[3], q[3];
+                for (int k = 0; k < 3; k++)
+                {
+                    p[k] = positions[tri[k]];
+                    q[k] = tri[k] == c.v ? positions[c.target] : p[k];
+                }
+                glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+                flips = glm::dot(before, after) <= 0.0f;
+            }
+            if (flips)
+                continue;
+
+            remap[c.v] = c.target;
+            // c.v 一环内的顶点本轮都不再折叠：它们的相邻三角形已变，上面的翻转检测基于的位置不再成立
+            for (unsigned int j = adjacencyOffsets[c.v]; j < adjacencyOffsets[c.v + 1]; j++)
+            {
+                const unsigned int *tri = &current[adjacency[j] * 3];
+                touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+            }
+            AddQuadric(quadrics[positionClass[c.target]], quadrics[positionClass[c.v]]);
+            maxAccepted = std::max(maxAccepted, c.cost);
+            removed += shared;
+            applied++;
+        }
+        if (applied == 0)
+            break;
+
+        // 重写索引并去掉退化三角形
+        size_t write = 0;
+        for (size_t i = 0; i < triangleCount * 3; i += 3)
+        {
+            unsigned int a = remap[current[i]];
+            unsigned int b = remap[current[i + 1]];
+            unsigned int c = remap[current[i + 2]];
+            if (a == b || b == c || a == c)
+                continue;
+            current[write++] = a;
+            current[write++] = b;
+            current[write++] = c;
+        }
+        current.resize(write);
+    }
+
+    std::copy(current.begin(), current.end(), destination);
+    if (resultError)
+        *resultError = std::sqrt(maxAccepted);
+    return current.size();
+}
+
+std::vector<MeshLod> MeshSimplifier::BuildLodChain(std::vector<unsigned int> &indices, const Vertex *vertices,
+                                                   size_t vertexCount, bool verbose)
+{
+    std::vector<MeshLod> lods;
+    lods.push_back(MeshLod{0, static_cast<unsigned int>(indices.size()), 0.0f});
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<unsigned int> previous(indices);
+    std::vector<unsigned int> simplified(indices.size());
+    float error = 0.0f;
+    while (static_cast<int>(lods.size()) < MAX_LODS)
+    {
+        size_t target = static_cast<size_t>(previous.size() / 3 * LOD_RATIO) * 3;
+        if (target < MIN_LOD_TRIANGLES * 3)
+            break;
+
+        float levelError = 0.0f;
+        size_t count = Simplify(simplified.data(), previous.data(), previous.size(), vertices, vertexCount, target,
+                                MAX_ERROR, &levelError);
+        // 被锁定顶点或误差上限挡住、几乎无法再简化时停止
+        if (count == 0 || count * 10 > previous.size() * 9)
+            break;
+
+        // 误差以上一级为基准，逐级累加作为相对原网格误差的上界
+        error += levelError;
+        previous.resize(count);
+        MeshOptimizer::OptimizeVertexCache(previous.data(), simplified.data(), count, vertexCount);
+
+        lods.push_back(MeshLod{static_cast<unsigned int>(indices.size()), static_cast<unsigned int>(count), error});
+        indices.insert(indices.end(), previous.begin(), previous.end());
+    }
+
+    if (verbose)
+    {
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "[MeshSimplifier] " << lods.size() << " LODs in " << ms << " ms:";
+        for (const MeshLod &lod : lods)
+            std::cout << " " << lod.indexCount / 3 << " (" << lod.error << ")";
+        std::cout << std::endl;
+    }
+    return lods;
+}
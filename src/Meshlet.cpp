@@ -0,0 +1,155 @@
+#include "Meshlet.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    const unsigned int NO_MESHLET = 0xFFFFFFFFu;
+
+    // 计算一个簇的包围球与法线锥
+    void ComputeBounds(Meshlet &meshlet, const unsigned int *indices, const Vertex *vertices)
+    {
+        const unsigned int *tri = indices;
+        glm::vec3 lo = vertices[tri[0]].Position, hi = lo;
+        for (unsigned int i = 0; i < meshlet.triangleCount * 3; i++)
+        {
+            lo = glm::min(lo, vertices[tri[i]].Position);
+            hi = glm::max(hi, vertices[tri[i]].Position);
+        }
+        meshlet.center = (lo + hi) * 0.5f;
+        float radius = 0.0f;
+        for (unsigned int i = 0; i < meshlet.triangleCount * 3; i++)
+            radius = std::max(radius, glm::length(vertices[tri[i]].Position - meshlet.center));
+        meshlet.radius = radius;
+
+        glm::vec3 normals[MeshletBuilder::MAX_TRIANGLES];
+        unsigned int normalCount = 0;
+        glm::vec3 sum(0.0f);
+        for (unsigned int t = 0; t < meshlet.triangleCount; t++)
+        {
+            const glm::vec3 &p0 = vertices[tri[t * 3 + 0]].Position;
+            const glm::vec3 &p1 = vertices[tri[t * 3 + 1]].Position;
+            const glm::vec3 &p2 = vertices[tri[t * 3 + 2]].Position;
+            glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+            float len = glm::length(n);
+            if (len <= 0.0f)
+                continue;
+            normals[normalCount] = n / len;
+            sum += normals[normalCount];
+            normalCount++;
+        }
+
+        meshlet.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+        meshlet.coneCutoff = 1.0f;
+        float sumLength = glm::length(sum);
+        if (normalCount == 0 || sumLength <= 0.0f)
+            return;
+        meshlet.coneAxis = sum / sumLength;
+
+        float minDot = 1.0f;
+        for (unsigned int i = 0; i < normalCount; i++)
+            minDot = std::min(minDot, glm::dot(meshlet.coneAxis, normals[i]));
+        // 锥角接近或超过 90 度时背面测试几乎不可能成立，直接关闭
+        if (minDot > 0.1f)
+            meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+}
+
+std::vector<Meshlet> MeshletBuilder::Build(const unsigned int *indices, size_t indexCount, const Vertex *vertices,
+                                           size_t vertexCount, unsigned int indexBase, bool verbose)
+{
+    std::vector<Meshlet> meshlets;
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+        return meshlets;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // stamp[v] 记录顶点最近被计入的簇，避免每个簇清空集合
+    std::vector<unsigned int> stamp(vertexCount, NO_MESHLET);
+    Meshlet current = Meshlet{0, 0, 0, glm::vec3(0.0f), 0.0f, glm::vec3(0.0f), 1.0f};
+    unsigned int id = 0;
+    size_t first = 0;
+
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        const unsigned int *tri = &indices[t * 3];
+        unsigned int added = 0;
+        for (int k = 0; k < 3; k++)
+            if (stamp[tri[k]] != id && (k == 0 || tri[k] != tri[0]) && (k < 2 || tri[k] != tri[1]))
+                added++;
+
+        if (current.triangleCount > 0 &&
+            (current.vertexCount + added > MAX_VERTICES || current.triangleCount + 1 > MAX_TRIANGLES))
+        {
+            current.indexOffset = indexBase + static_cast<unsigned int>(first * 3);
+            ComputeBounds(current, &indices[first * 3], vertices);
+            meshlets.push_back(current);
+            id++;
+            first = t;
+            current.triangleCount = 0;
+            current.vertexCount = 0;
+        }
+
+        for (int k = 0; k < 3; k++)
+        {
+            if (stamp[tri[k]] != id)
+            {
+                stamp[tri[k]] = id;
+                current.vertexCount++;
+            }
+        }
+        current.triangleCount++;
+    }
+    current.indexOffset = indexBase + static_cast<unsigned int>(first * 3);
+    ComputeBounds(current, &indices[first * 3], vertices);
+    meshlets.push_back(current);
+
+    if (!verbose)
+        return meshlets;
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    size_t totalVertices = 0;
+    for (const Meshlet &m : meshlets)
+        totalVertices += m.vertexCount;
+    std::cout << "[MeshletBuilder] " << meshlets.size() << " meshlets (avg "
+              << static_cast<double>(totalVertices) / meshlets.size() << " vertices, "
+              << static_cast<double>(triangleCount) / meshlets.size() << " triangles) in " << ms << " ms" << std::endl;
+    return meshlets;
+}
+
+bool MeshletBuilder::IsVisible(const Meshlet &meshlet, const glm::vec4 *planes, const glm::vec3 &cameraLocal)
+{
+    for (int i = 0; i < 6; i++)
+        if (glm::dot(glm::vec3(planes[i]), meshlet.center) + planes[i].w < -meshlet.radius)
+            return false;
+
+    // 法线锥：相机位于簇内所有三角形平面的背面时整簇不可见
+    glm::vec3 toCenter = meshlet.center - cameraLocal;
+    float distance = glm::length(toCenter);
+    if (glm::dot(toCenter, meshlet.coneAxis) >= meshlet.coneCutoff * distance + meshlet.radius)
+        return false;
+    return true;
+}
+
+void MeshletBuilder::ExtractFrustumPlanes(const glm::mat4 &clip, glm::vec4 *planes)
+{
+    // Gribb-Hartmann：平面 = 第 4 行 ± 第 1/2/3 行（glm 为列主序）
+    glm::vec4 row0(clip[0][0], clip[1][0], clip[2][0], clip[3][0]);
+    glm::vec4 row1(clip[0][1], clip[1][1], clip[2][1], clip[3][1]);
+    glm::vec4 row2(clip[0][2], clip[1][2], clip[2][2], clip[3][2]);
+    glm::vec4 row3(clip[0][3], clip[1][3], clip[2][3], clip[3][3]);
+    planes[0] = row3 + row0; // left
+    planes[1] = row3 - row0; // right
+    planes[2] = row3 + row1; // bottom
+    planes[3] = row3 - row1; // top
+    planes[4] = row3 + row2; // near
+    planes[5] = row3 - row2; // far
+    for (int i = 0; i < 6; i++)
+    {
+        float len = glm::length(glm::vec3(planes[i]));
+        if (len > 0.0f)
+            planes[i] /= len;
+    }
+}
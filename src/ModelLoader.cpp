@@ -1,26 +1,339 @@
 #include "ModelLoader.h"
+#include "GltfLoader.h"
+#include "MappedFile.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "NormalGenerator.h"
+#include "ObjParser.h"
+#include "PlyReader.h"
+#include "StlReader.h"
+#include "ImportProgress.h"
+#include "ThreadPool.h"
+#include "TripletHashMap.h"
+#include "VertexPacker.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
 #include <iostream>
 
-// [Part B] STUB: 这是一个桩函数，用于 Part A 开发测试。
-// Part B 同学需要删除此处的硬编码，改为真实的文件读取。
-Mesh* ModelLoader::LoadMesh(const std::string& path) {
-    std::cout << "[Part B Stub] Loading model from: " << path << std::endl;
+namespace
+{
+    // 角点去重：相同 (v, vt, vn) 的角点共享同一个 Vertex，输出紧凑的索引网格
+    // 缺少法线的角点以 (v, vt) 去重并在 generatedNormal 中标记，由 NormalGenerator 统一生成；
+    // positionIds 记录每个顶点的 v，使 UV 接缝两侧的顶点之间同样平滑
+    // 进度汇报与取消检查的间隔（三角形数）
+    const size_t PROGRESS_STEP_TRIANGLES = 1 << 18;
 
-    // 临时：返回一个简单的三角形，证明接口调用成功
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
-    std::vector<Texture> textures;
+    // 返回 false 表示导入已被取消
+    bool BuildIndexedMesh(const ObjData &obj, std::vector<Vertex> &vertices, std::vector<unsigned int> &indices,
+                          std::vector<uint32_t> &positionIds, std::vector<unsigned char> &generatedNormal,
+                          ImportProgress *progress)
+    {
+        const int positionCount = static_cast<int>(obj.positions.size());
+        const int texCoordCount = static_cast<int>(obj.texCoords.size());
+        const int normalCount = static_cast<int>(obj.normals.size());
 
-    Vertex v1, v2, v3;
-    v1.Position = glm::vec3(-0.5f, -0.5f, 0.0f); v1.Normal = glm::vec3(0,0,1);
-    v2.Position = glm::vec3( 0.5f, -0.5f, 0.0f); v2.Normal = glm::vec3(0,0,1);
-    v3.Position = glm::vec3( 0.0f,  0.5f, 0.0f); v3.Normal = glm::vec3(0,0,1);
+        TripletHashMap cornerMap(obj.corners.size() / 4);
 
-    vertices.push_back(v1);
-    vertices.push_back(v2);
-    vertices.push_back(v3);
+        vertices.reserve(obj.corners.size() / 4);
+        indices.reserve(obj.corners.size());
 
-    indices.push_back(0); indices.push_back(1); indices.push_back(2);
+        for (size_t i = 0; i + 2 < obj.corners.size(); i += 3)
+        {
+            if (progress && (i / 3) % PROGRESS_STEP_TRIANGLES == 0)
+            {
+                if (progress->IsCancelled())
+                    return false;
+                progress->Report(static_cast<float>(i) / static_cast<float>(obj.corners.size()));
+            }
 
-    return new Mesh(vertices, indices, textures);
-}
\ No newline at end of file
+            const ObjIndex *tri = &obj.corners[i];
+
+            // 位置下标越界的三角形直接丢弃
+            bool valid = true;
+            for (int k = 0; k < 3; k++)
+                valid = valid && tri[k].v >= 0 && tri[k].v < positionCount;
+            if (!valid)
+                continue;
+
+            for (int k = 0; k < 3; k++)
+            {
+                int vt = (tri[k].vt >= 0 && tri[k].vt < texCoordCount) ? tri[k].vt : -1;
+                int vn = (tri[k].vn >= 0 && tri[k].vn < normalCount) ? tri[k].vn : -1;
+
+                unsigned int next = static_cast<unsigned int>(vertices.size());
+                unsigned int index = cornerMap.FindOrInsert(static_cast<uint32_t>(tri[k].v), static_cast<uint32_t>(vt),
+                                                            static_cast<uint32_t>(vn), next);
+                if (index == next)
+                {
+                    Vertex vertex;
+                    vertex.Position = obj.positions[tri[k].v];
+                    vertex.Normal = vn >= 0 ? obj.normals[vn] : glm::vec3(0.0f);
+                    vertex.TexCoords = vt >= 0 ? obj.texCoords[vt] : glm::vec2(0.0f);
+                    vertices.push_back(vertex);
+                    positionIds.push_back(static_cast<uint32_t>(tri[k].v));
+                    generatedNormal.push_back(vn < 0 ? 1 : 0);
+                }
+                indices.push_back(index);
+            }
+        }
+        return true;
+    }
+
+    const char *FormatName(ModelFormat format)
+    {
+        switch (format)
+        {
+        case ModelFormat::Stl:
+            return "STL";
+        case ModelFormat::Ply:
+            return "PLY";
+        case ModelFormat::Gltf:
+            return "glTF";
+        default:
+            return "OBJ";
+        }
+    }
+
+    void ComputeBounds(MeshData &data)
+    {
+        if (data.vertexCount == 0)
+            return;
+        data.bounds = BoundingVolume::FromPositions(&data.vertexData[0].Position, data.vertexCount, sizeof(Vertex));
+    }
+}
+
+Mesh *ModelLoader::LoadMesh(const std::string &path)
+{
+    MeshData data;
+    if (!LoadMeshData(path, data))
+        return nullptr;
+    return CreateMesh(data);
+}
+
+Mesh *ModelLoader::CreateMesh(const MeshData &data)
+{
+    Mesh *mesh;
+    if (!data.packedVertices.empty())
+        mesh = new Mesh(data.packedVertices.data(), data.packedVertices.size(), data.indexData, data.indexCount,
+                        data.indexType, data.quantization, data.bounds, std::vector<Texture>());
+    else
+        mesh = new Mesh(data.vertexData, data.vertexCount, data.indexData, data.indexCount, data.indexType,
+                        data.bounds, std::vector<Texture>());
+    mesh->lods = data.lods;
+    mesh->meshlets = data.meshlets;
+    return mesh;
+}
+
+ModelFormat ModelLoader::DetectFormat(const std::string &path, const char *data, size_t size)
+{
+    if (data)
+    {
+        if (GltfLoader::IsGlb(data, size))
+            return ModelFormat::Gltf;
+        if (PlyReader::IsPly(data, size))
+            return ModelFormat::Ply;
+        if (StlReader::IsBinary(data, size))
+            return ModelFormat::Stl;
+    }
+
+    // ASCII STL 以 "solid" 开头，但二进制 STL 的文件头也可能如此，因此 ASCII 只按扩展名识别
+    std::string extension;
+    size_t dot = path.find_last_of('.');
+    if (dot != std::string::npos)
+        extension = path.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c)
+                   { return static_cast<char>(std::tolower(c)); });
+    if (extension == "stl")
+        return ModelFormat::Stl;
+    if (extension == "ply")
+        return ModelFormat::Ply;
+    if (extension == "glb")
+        return ModelFormat::Gltf;
+    return ModelFormat::Obj;
+}
+
+bool ModelLoader::LoadMeshData(const std::string &path, MeshData &out, ImportProgress *progress,
+                               const ImportOptions &options)
+{
+    if (!LoadIndexedMesh(path, out, progress, options))
+        return false;
+
+    // 打包在后台线程完成，主线程只负责上传
+    if (options.packVertices)
+    {
+        out.quantization = VertexPacker::Pack(out.vertexData, out.vertexCount, out.packedVertices);
+        PackError error = VertexPacker::MeasureError(out.vertexData, out.packedVertices.data(), out.vertexCount,
+                                                     out.quantization);
+        std::cout << "[ModelLoader] Packed " << out.vertexCount << " vertices: " << sizeof(Vertex) << " -> "
+                  << sizeof(PackedVertex) << " bytes each (max error: position " << error.position << ", normal "
+                  << error.normalDegrees << " deg, uv " << error.texCoord << ")" << std::endl;
+    }
+    return true;
+}
+
+bool ModelLoader::LoadIndexedMesh(const std::string &path, MeshData &out, ImportProgress *progress,
+                                  const ImportOptions &options)
+{
+    std::cout << "[ModelLoader] Loading model from: " << path << std::endl;
+
+    ThreadPool &pool = ThreadPool::Global();
+    auto start = std::chrono::steady_clock::now();
+
+    // 1. 优先读取二进制缓存
+    if (progress)
+        progress->BeginStage("Reading cache", 0.0f, 0.0f);
+    if (MeshCache::Load(path, out, pool))
+    {
+        if (progress)
+            progress->BeginStage("Done", 1.0f, 0.0f);
+        double cacheMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "[ModelLoader] Cache hit: " << MeshCache::CachePath(path) << " (" << out.vertexCount
+                  << " vertices, " << (out.lods.empty() ? out.indexCount : out.lods[0].indexCount) / 3 << " triangles, "
+                  << out.lods.size() << " LODs) in " << cacheMs << " ms" << std::endl;
+        return true;
+    }
+
+    // 2. 未命中：按格式解析源文件
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        std::cerr << "[ModelLoader] Cannot open file: " << path << std::endl;
+        return false;
+    }
+
+    const ModelFormat format = DetectFormat(path, file.Data(), file.Size());
+    if (format == ModelFormat::Gltf)
+    {
+        // glTF 场景包含多个图元，需通过 GltfLoader 导入为多个对象
+        std::cerr << "[ModelLoader] glTF files are imported through GltfLoader: " << path << std::endl;
+        return false;
+    }
+    start = std::chrono::steady_clock::now();
+
+    size_t chunkCount = 0;
+    size_t sourcePositions = 0;
+    bool completed;
+    std::chrono::steady_clock::time_point parsed;
+    if (format == ModelFormat::Obj)
+    {
+        ObjData obj;
+        if (progress)
+            progress->BeginStage("Parsing", 0.0f, 0.5f);
+        chunkCount = ObjParser::ParseParallel(file.Data(), file.Data() + file.Size(), obj, pool, progress);
+        if (progress && progress->IsCancelled())
+        {
+            std::cout << "[ModelLoader] Import cancelled: " << path << std::endl;
+            return false;
+        }
+
+        parsed = std::chrono::steady_clock::now();
+        sourcePositions = obj.positions.size();
+
+        if (progress)
+            progress->BeginStage("Deduplicating", 0.5f, 0.25f);
+        std::vector<uint32_t> positionIds;
+        std::vector<unsigned char> generatedNormal;
+        completed = BuildIndexedMesh(obj, out.vertices, out.indices, positionIds, generatedNormal, progress);
+
+        // 没有 vn 的角点：并行生成面积与角度加权的平滑法线，硬边处拆分顶点
+        if (completed && std::find(generatedNormal.begin(), generatedNormal.end(), 1) != generatedNormal.end())
+        {
+            if (progress)
+                progress->BeginStage("Generating normals", 0.75f, 0.05f);
+            NormalGenerator::Generate(out.vertices, out.indices, pool, NormalGenerator::DEFAULT_CREASE_ANGLE,
+                                      &positionIds, &generatedNormal);
+        }
+    }
+    else
+    {
+        // STL / PLY 直接写入顶点与索引数组（STL 读取时按位置焊接）
+        if (progress)
+            progress->BeginStage("Parsing", 0.0f, 0.8f);
+        if (format == ModelFormat::Stl)
+            completed = StlReader::Read(file.Data(), file.Size(), out.vertices, out.indices, progress);
+        else
+            completed = PlyReader::Read(file.Data(), file.Size(), out.vertices, out.indices, progress);
+        parsed = std::chrono::steady_clock::now();
+        sourcePositions = format == ModelFormat::Stl ? out.indices.size() : out.vertices.size();
+    }
+
+    if (!completed)
+    {
+        if (progress && progress->IsCancelled())
+            std::cout << "[ModelLoader] Import cancelled: " << path << std::endl;
+        else
+            std::cerr << "[ModelLoader] Failed to read " << FormatName(format) << " file: " << path << std::endl;
+        return false;
+    }
+
+    // 上传前重排索引与顶点（顶点缓存、过度绘制、顶点读取），结果随缓存保存
+    if (progress)
+        progress->BeginStage("Optimizing", 0.8f, 0.05f);
+    MeshOptimizer::Optimize(out.vertices, out.indices);
+
+    // 生成 LOD 链，各级索引追加在 LOD0 之后
+    if (progress)
+        progress->BeginStage("Simplifying", 0.85f, 0.05f);
+    out.lods = MeshSimplifier::BuildLodChain(out.indices, out.vertices.data(), out.vertices.size());
+    const size_t baseIndexCount = out.lods[0].indexCount;
+
+    // LOD0 按顺序切分网格簇，供逐簇剔除
+    out.meshlets = MeshletBuilder::Build(out.indices.data(), baseIndexCount, out.vertices.data(), out.vertices.size());
+    out.UseOwnedArrays();
+    ComputeBounds(out);
+
+    auto built = std::chrono::steady_clock::now();
+
+    double parseMs = std::chrono::duration<double, std::milli>(parsed - start).count();
+    double buildMs = std::chrono::duration<double, std::milli>(built - parsed).count();
+    double sizeMB = file.Size() / (1024.0 * 1024.0);
+    double mbps = parseMs > 0.0 ? sizeMB / (parseMs / 1000.0) : 0.0;
+
+    std::cout << "[ModelLoader] Parsed " << FormatName(format) << " " << sizeMB << " MB in " << parseMs << " ms ("
+              << mbps << " MB/s";
+    if (format == ModelFormat::Obj)
+        std::cout << ", " << chunkCount << " chunks on " << pool.Concurrency() << " threads";
+    std::cout << "), build " << buildMs << " ms" << std::endl;
+    std::cout << "[ModelLoader] " << sourcePositions << " positions, "
+              << baseIndexCount / 3 << " triangles" << std::endl;
+    if (out.vertexCount > 0)
+        std::cout << "[ModelLoader] Dedup: " << baseIndexCount << " corners -> " << out.vertexCount
+                  << " vertices (ratio " << static_cast<double>(baseIndexCount) / out.vertexCount << ":1)" << std::endl;
+    if (format == ModelFormat::Obj && mbps < TARGET_PARSE_MBPS * pool.Concurrency() && sizeMB >= 16.0)
+        std::cout << "[ModelLoader] Warning: parse throughput below target ("
+                  << TARGET_PARSE_MBPS << " MB/s per thread)" << std::endl;
+
+    if (out.indexCount == 0)
+    {
+        std::cerr << "[ModelLoader] No triangles found in: " << path << std::endl;
+        return false;
+    }
+
+    // 3. 写入缓存，失败（例如目录只读）不影响本次导入
+    if (progress)
+        progress->BeginStage("Writing cache", 0.9f, 0.1f);
+    uint64_t sourceHash = MeshCache::HashContent(file.Data(), file.Size(), pool);
+    if (MeshCache::Save(path, out, sourceHash, options.compressCache))
+    {
+        std::cout << "[ModelLoader] Wrote cache: " << MeshCache::CachePath(path);
+        if (options.compressCache)
+        {
+            std::error_code ec;
+            double raw = static_cast<double>(out.vertexCount * sizeof(Vertex) + out.indexCount * sizeof(unsigned int));
+            uintmax_t written = std::filesystem::file_size(MeshCache::CachePath(path), ec);
+            if (!ec && written > 0)
+                std::cout << " (compressed " << raw / written << ":1)";
+        }
+        std::cout << std::endl;
+    }
+    else
+        std::cerr << "[ModelLoader] Could not write cache: " << MeshCache::CachePath(path) << std::endl;
+
+    if (progress)
+        progress->BeginStage("Done", 1.0f, 0.0f);
+    return true;
+}
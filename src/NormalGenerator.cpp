@@ -0,0 +1,233 @@
+#include "NormalGenerator.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+namespace
+{
+    // 一个位置上的一组角点：共享同一个法线
+    struct Cluster
+    {
+        glm::vec3 seed; // 第一个非退化面的单位法线，用于折痕判断
+        glm::vec3 sum;  // 加权法线之和
+        bool hasSeed;
+    };
+
+    // 顶点与组的对应：同一顶点的第一个组沿用原顶点，其余组复制出新顶点
+    struct Assignment
+    {
+        unsigned int vertex;
+        unsigned int cluster;
+        unsigned int target; // 原顶点下标，或块内新顶点序号 | NEW_VERTEX
+    };
+
+    const unsigned int NEW_VERTEX = 0x80000000u;
+
+    // 每个块的拆分结果，全部块完成后统一编号
+    struct BlockResult
+    {
+        std::vector<Vertex> vertices;
+        std::vector<std::pair<uint32_t, uint32_t>> rewrites; // (角点, 块内新顶点序号)
+    };
+
+    glm::vec3 SafeNormalize(const glm::vec3 &v)
+    {
+        float len = glm::length(v);
+        return len > 0.0f ? v / len : glm::vec3(0.0f, 1.0f, 0.0f);
+    }
+
+    // 角点的加权面法线：叉积（长度为面积的两倍）乘以该角点处的夹角
+    glm::vec3 CornerNormal(const std::vector<Vertex> &vertices, const unsigned int *tri, int k, glm::vec3 &faceUnit,
+                           bool &degenerate)
+    {
+        const glm::vec3 &p0 = vertices[tri[k]].Position;
+        const glm::vec3 &p1 = vertices[tri[(k + 1) % 3]].Position;
+        const glm::vec3 &p2 = vertices[tri[(k + 2) % 3]].Position;
+        glm::vec3 e1 = p1 - p0;
+        glm::vec3 e2 = p2 - p0;
+        glm::vec3 cross = glm::cross(e1, e2);
+        float crossLength = glm::length(cross);
+        float lengths = glm::length(e1) * glm::length(e2);
+        degenerate = crossLength <= 0.0f || lengths <= 0.0f;
+        if (degenerate)
+            return glm::vec3(0.0f);
+        faceUnit = cross / crossLength;
+        float cosAngle = std::max(-1.0f, std::min(1.0f, glm::dot(e1, e2) / lengths));
+        return cross * std::acos(cosAngle);
+    }
+}
+
+size_t NormalGenerator::Generate(std::vector<Vertex> &vertices, std::vector<unsigned int> &indices, ThreadPool &pool,
+                                 float creaseAngle, const std::vector<uint32_t> *positionIds,
+                                 const std::vector<unsigned char> *generate)
+{
+    const size_t triangleCount = indices.size() / 3;
+    const size_t vertexCount = vertices.size();
+    if (triangleCount == 0 || vertexCount == 0)
+        return 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    size_t keyCount = vertexCount;
+    if (positionIds)
+    {
+        keyCount = 0;
+        for (uint32_t id : *positionIds)
+            keyCount = std::max(keyCount, static_cast<size_t>(id) + 1);
+    }
+    auto KeyOf = [&](unsigned int v) -> size_t
+    { return positionIds ? (*positionIds)[v] : v; };
+    auto Wants = [&](unsigned int v)
+    { return !generate || (*generate)[v] != 0; };
+
+    const size_t taskCount = triangleCount < PARALLEL_MIN_TRIANGLES ? 1 : pool.Concurrency() * 4;
+    const size_t trianglesPerTask = (triangleCount + taskCount - 1) / taskCount;
+
+    // 1. 统计每个位置的角点数（原子计数，顺序无关）
+    std::unique_ptr<std::atomic<uint32_t>[]> cursors(new std::atomic<uint32_t>[keyCount]);
+    for (size_t i = 0; i < keyCount; i++)
+        cursors[i].store(0, std::memory_order_relaxed);
+
+    pool.ParallelFor(taskCount, [&](size_t task)
+                     {
+        size_t end = std::min(triangleCount, (task + 1) * trianglesPerTask);
+        for (size_t c = task * trianglesPerTask * 3; c < end * 3; c++)
+            if (Wants(indices[c]))
+                cursors[KeyOf(indices[c])].fetch_add(1, std::memory_order_relaxed); });
+
+    std::vector<uint32_t> offsets(keyCount + 1);
+    uint32_t total = 0;
+    for (size_t i = 0; i < keyCount; i++)
+    {
+        offsets[i] = total;
+        total += cursors[i].load(std::memory_order_relaxed);
+        cursors[i].store(offsets[i], std::memory_order_relaxed);
+    }
+    offsets[keyCount] = total;
+
+    // 2. 填充邻接表（表内顺序取决于线程调度，处理前排序以保证结果确定）
+    std::vector<uint32_t> corners(total);
+    pool.ParallelFor(taskCount, [&](size_t task)
+                     {
+        size_t end = std::min(triangleCount, (task + 1) * trianglesPerTask);
+        for (size_t c = task * trianglesPerTask * 3; c < end * 3; c++)
+            if (Wants(indices[c]))
+                corners[cursors[KeyOf(indices[c])].fetch_add(1, std::memory_order_relaxed)] = static_cast<uint32_t>(c); });
+    cursors.reset();
+
+    // 3. 按位置分组计算法线；原顶点的法线直接写入（每个顶点只属于一个位置，无数据竞争）
+    const float cosCrease = creaseAngle >= 180.0f ? -2.0f : std::cos(glm::radians(creaseAngle));
+    const size_t keysPerTask = (keyCount + taskCount - 1) / taskCount;
+    std::vector<BlockResult> results(taskCount);
+
+    pool.ParallelFor(taskCount, [&](size_t task)
+                     {
+        BlockResult &result = results[task];
+        std::vector<Cluster> clusters;
+        std::vector<unsigned int> cornerCluster;
+        std::vector<Assignment> assignments;
+        size_t keyEnd = std::min(keyCount, (task + 1) * keysPerTask);
+
+        for (size_t key = task * keysPerTask; key < keyEnd; key++)
+        {
+            uint32_t *list = corners.data() + offsets[key];
+            size_t count = offsets[key + 1] - offsets[key];
+            if (count == 0)
+                continue;
+            std::sort(list, list + count);
+
+            // 贪心分组：与某组种子法线夹角不超过折痕角的面加入该组
+            clusters.clear();
+            cornerCluster.resize(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                const unsigned int *tri = &indices[list[i] / 3 * 3];
+                glm::vec3 faceUnit(0.0f);
+                bool degenerate;
+                glm::vec3 weighted = CornerNormal(vertices, tri, static_cast<int>(list[i] % 3), faceUnit, degenerate);
+
+                size_t g = 0;
+                if (!degenerate)
+                {
+                    while (g < clusters.size() && clusters[g].hasSeed && glm::dot(clusters[g].seed, faceUnit) < cosCrease)
+                        g++;
+                }
+                if (g == clusters.size())
+                    clusters.push_back(Cluster{glm::vec3(0.0f), glm::vec3(0.0f), false});
+                if (!degenerate && !clusters[g].hasSeed)
+                {
+                    clusters[g].seed = faceUnit;
+                    clusters[g].hasSeed = true;
+                }
+                clusters[g].sum += weighted;
+                cornerCluster[i] = static_cast<unsigned int>(g);
+            }
+
+            assignments.clear();
+            for (size_t i = 0; i < count; i++)
+            {
+                unsigned int vertex = indices[list[i]];
+                unsigned int cluster = cornerCluster[i];
+                const Assignment *found = nullptr;
+                bool vertexSeen = false;
+                for (const Assignment &a : assignments)
+                {
+                    if (a.vertex != vertex)
+                        continue;
+                    vertexSeen = true;
+                    if (a.cluster == cluster)
+                    {
+                        found = &a;
+                        break;
+                    }
+                }
+
+                unsigned int target;
+                if (found)
+                {
+                    target = found->target;
+                }
+                else if (!vertexSeen)
+                {
+                    target = vertex;
+                    vertices[vertex].Normal = SafeNormalize(clusters[cluster].sum);
+                    assignments.push_back(Assignment{vertex, cluster, target});
+                }
+                else
+                {
+                    target = NEW_VERTEX | static_cast<unsigned int>(result.vertices.size());
+                    Vertex copy = vertices[vertex];
+                    copy.Normal = SafeNormalize(clusters[cluster].sum);
+                    result.vertices.push_back(copy);
+                    assignments.push_back(Assignment{vertex, cluster, target});
+                }
+                if (target & NEW_VERTEX)
+                    result.rewrites.emplace_back(list[i], target & ~NEW_VERTEX);
+            }
+        } });
+
+    // 4. 按块顺序追加拆分出的顶点并改写对应角点
+    std::vector<size_t> bases(taskCount);
+    size_t added = 0;
+    for (size_t task = 0; task < taskCount; task++)
+    {
+        bases[task] = vertexCount + added;
+        added += results[task].vertices.size();
+    }
+    vertices.reserve(vertexCount + added);
+    for (const BlockResult &result : results)
+        vertices.insert(vertices.end(), result.vertices.begin(), result.vertices.end());
+    pool.ParallelFor(taskCount, [&](size_t task)
+                     {
+        for (const auto &rewrite : results[task].rewrites)
+            indices[rewrite.first] = static_cast<unsigned int>(bases[task] + rewrite.second); });
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[NormalGenerator] " << total << " corners, " << added << " vertices split at "
+              << creaseAngle << " deg creases in " << ms << " ms" << std::endl;
+    return added;
+}
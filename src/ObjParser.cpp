@@ -0,0 +1,359 @@
+#include "ObjParser.h"
+#include "ThreadPool.h"
+#include "ImportProgress.h"
+#include <atomic>
+#include <algorithm>
+#include <charconv>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OBJ_PARSER_SSE2 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace
+{
+    inline bool IsBlank(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    inline const char *SkipBlank(const char *p, const char *end)
+    {
+        while (p < end && IsBlank(*p))
+            ++p;
+        return p;
+    }
+
+    inline const char *SkipToken(const char *p, const char *end)
+    {
+        while (p < end && !IsBlank(*p))
+            ++p;
+        return p;
+    }
+
+    // std::from_chars 不接受前导 '+'，手动跳过
+    inline const char *ParseFloat(const char *p, const char *end, float &value)
+    {
+        p = SkipBlank(p, end);
+        if (p < end && *p == '+')
+            ++p;
+        auto result = std::from_chars(p, end, value);
+        if (result.ec != std::errc())
+        {
+            value = 0.0f;
+            return SkipToken(p, end);
+        }
+        return result.ptr;
+    }
+
+    // 下标只含十进制数字，手写循环比 from_chars 的通用路径更快
+    inline const char *ParseInt(const char *p, const char *end, int &value)
+    {
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+'))
+        {
+            negative = (*p == '-');
+            ++p;
+        }
+        int result = 0;
+        while (p < end && static_cast<unsigned char>(*p - '0') < 10)
+        {
+            result = result * 10 + (*p - '0');
+            ++p;
+        }
+        value = negative ? -result : result;
+        return p;
+    }
+
+    // 负下标是相对"当前已读取数量"的引用。分块解析时块内只知道局部数量，
+    // 因此先编码为 (局部位置 - RELATIVE_BIAS)，合并时再加上块的起始偏移。
+    // 编码值恒 <= -2，与缺省值 -1 和绝对下标 (>= 0) 互不冲突
+    const int RELATIVE_BIAS = (1 << 30) + 2;
+
+    // OBJ 下标从 1 开始
+    inline int ResolveIndex(int raw, size_t count)
+    {
+        if (raw > 0)
+            return raw - 1;
+        if (raw < 0)
+            return static_cast<int>(count) + raw - RELATIVE_BIAS;
+        return -1;
+    }
+
+    inline int FixupIndex(int index, int base)
+    {
+        return index <= -2 ? index + RELATIVE_BIAS + base : index;
+    }
+
+    // 解析一个角点 "v", "v/vt", "v//vn", "v/vt/vn"
+    inline const char *ParseCorner(const char *p, const char *end, const ObjData &data, ObjIndex &corner)
+    {
+        int raw = 0;
+        p = ParseInt(p, end, raw);
+        corner.v = ResolveIndex(raw, data.positions.size());
+        corner.vt = -1;
+        corner.vn = -1;
+
+        if (p < end && *p == '/')
+        {
+            ++p;
+            if (p < end && *p != '/')
+            {
+                p = ParseInt(p, end, raw);
+                corner.vt = ResolveIndex(raw, data.texCoords.size());
+            }
+            if (p < end && *p == '/')
+            {
+                ++p;
+                p = ParseInt(p, end, raw);
+                corner.vn = ResolveIndex(raw, data.normals.size());
+            }
+        }
+        // 跳过无法识别的尾随字符，保证前进
+        return SkipToken(p, end);
+    }
+
+    void ParseFace(const char *p, const char *end, ObjData &data)
+    {
+        ObjIndex first = {-1, -1, -1};
+        ObjIndex prev = {-1, -1, -1};
+        ObjIndex corner;
+        int count = 0;
+
+        while (true)
+        {
+            p = SkipBlank(p, end);
+            if (p >= end)
+                break;
+            p = ParseCorner(p, end, data, corner);
+
+            if (count == 0)
+            {
+                first = corner;
+            }
+            else if (count >= 2)
+            {
+                // 扇形三角化：(0, i-1, i)
+                data.corners.push_back(first);
+                data.corners.push_back(prev);
+                data.corners.push_back(corner);
+            }
+            prev = corner;
+            ++count;
+        }
+    }
+
+    void ParseLine(const char *p, const char *end, ObjData &data)
+    {
+        p = SkipBlank(p, end);
+        if (end - p < 2)
+            return;
+
+        if (p[0] == 'v')
+        {
+            if (IsBlank(p[1]))
+            {
+                glm::vec3 v;
+                p = ParseFloat(p + 2, end, v.x);
+                p = ParseFloat(p, end, v.y);
+                ParseFloat(p, end, v.z);
+                data.positions.push_back(v);
+            }
+            else if (end - p >= 3 && p[1] == 't' && IsBlank(p[2]))
+            {
+                glm::vec2 vt;
+                p = ParseFloat(p + 3, end, vt.x);
+                ParseFloat(p, end, vt.y);
+                data.texCoords.push_back(vt);
+            }
+            else if (end - p >= 3 && p[1] == 'n' && IsBlank(p[2]))
+            {
+                glm::vec3 vn;
+                p = ParseFloat(p + 3, end, vn.x);
+                p = ParseFloat(p, end, vn.y);
+                ParseFloat(p, end, vn.z);
+                data.normals.push_back(vn);
+            }
+        }
+        else if (p[0] == 'f' && IsBlank(p[1]))
+        {
+            ParseFace(p + 2, end, data);
+        }
+        // 其余记录（注释、o/g/s/usemtl/mtllib 等）暂不处理
+    }
+}
+
+const char *ObjParser::FindNewline(const char *p, const char *end)
+{
+#ifdef OBJ_PARSER_SSE2
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (end - p >= 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+        if (mask != 0)
+        {
+#ifdef _MSC_VER
+            unsigned long bit;
+            _BitScanForward(&bit, static_cast<unsigned long>(mask));
+            return p + bit;
+#else
+            return p + __builtin_ctz(static_cast<unsigned int>(mask));
+#endif
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && *p != '\n')
+        ++p;
+    return p;
+}
+
+namespace
+{
+    // 每解析这么多字节汇报一次进度并检查取消标志
+    const size_t PROGRESS_STEP_BYTES = 1024 * 1024;
+
+    struct ChunkProgress
+    {
+        ImportProgress *progress;
+        std::atomic<size_t> bytesDone{0};
+        size_t totalBytes;
+
+        // 返回 false 表示导入已被取消
+        bool Advance(size_t bytes)
+        {
+            size_t done = bytesDone.fetch_add(bytes) + bytes;
+            progress->Report(static_cast<float>(done) / static_cast<float>(totalBytes));
+            return !progress->IsCancelled();
+        }
+    };
+
+    void ParseChunk(const char *begin, const char *end, ObjData &out, ChunkProgress *tracker)
+    {
+        // 按典型 OBJ 的字节密度预留容量，避免解析过程中频繁扩容
+        size_t bytes = static_cast<size_t>(end - begin);
+        out.positions.reserve(out.positions.size() + bytes / 128);
+        out.corners.reserve(out.corners.size() + bytes / 32);
+
+        const char *p = begin;
+        const char *lastReport = begin;
+        while (p < end)
+        {
+            const char *lineEnd = ObjParser::FindNewline(p, end);
+            ParseLine(p, lineEnd, out);
+            p = (lineEnd < end) ? lineEnd + 1 : end;
+
+            if (tracker && static_cast<size_t>(p - lastReport) >= PROGRESS_STEP_BYTES)
+            {
+                if (!tracker->Advance(static_cast<size_t>(p - lastReport)))
+                    return;
+                lastReport = p;
+            }
+        }
+    }
+
+    void FixupCorners(ObjIndex *corners, size_t count, int vBase, int vtBase, int vnBase)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            corners[i].v = FixupIndex(corners[i].v, vBase);
+            corners[i].vt = FixupIndex(corners[i].vt, vtBase);
+            corners[i].vn = FixupIndex(corners[i].vn, vnBase);
+        }
+    }
+}
+
+void ObjParser::Parse(const char *begin, const char *end, ObjData &out)
+{
+    ParseChunk(begin, end, out, nullptr);
+    FixupCorners(out.corners.data(), out.corners.size(), 0, 0, 0);
+}
+
+void ObjParser::ParseSection(const char *begin, const char *end, ObjData &out,
+                             size_t positionBase, size_t texCoordBase, size_t normalBase)
+{
+    ParseChunk(begin, end, out, nullptr);
+    FixupCorners(out.corners.data(), out.corners.size(), static_cast<int>(positionBase),
+                 static_cast<int>(texCoordBase), static_cast<int>(normalBase));
+}
+
+size_t ObjParser::ParseParallel(const char *begin, const char *end, ObjData &out, ThreadPool &pool,
+                                ImportProgress *progress)
+{
+    size_t bytes = static_cast<size_t>(end - begin);
+
+    ChunkProgress tracker;
+    tracker.progress = progress;
+    tracker.totalBytes = bytes;
+    ChunkProgress *trackerPtr = progress ? &tracker : nullptr;
+
+    if (bytes < PARALLEL_MIN_BYTES || pool.Concurrency() == 1)
+    {
+        ParseChunk(begin, end, out, trackerPtr);
+        FixupCorners(out.corners.data(), out.corners.size(), 0, 0, 0);
+        return 1;
+    }
+
+    // 每线程约 4 块以平衡负载，但每块不小于 1 MB
+    size_t chunkCount = std::min<size_t>(pool.Concurrency() * 4, bytes / (1024 * 1024));
+
+    // 1. 在行边界处切分
+    std::vector<const char *> bounds(chunkCount + 1);
+    bounds[0] = begin;
+    for (size_t i = 1; i < chunkCount; i++)
+    {
+        const char *target = begin + bytes * i / chunkCount;
+        if (target < bounds[i - 1])
+            target = bounds[i - 1];
+        const char *newline = FindNewline(target, end);
+        bounds[i] = (newline < end) ? newline + 1 : end;
+    }
+    bounds[chunkCount] = end;
+
+    // 2. 各块独立解析
+    std::vector<ObjData> chunks(chunkCount);
+    pool.ParallelFor(chunkCount, [&](size_t i)
+                     { ParseChunk(bounds[i], bounds[i + 1], chunks[i], trackerPtr); });
+    if (progress && progress->IsCancelled())
+        return chunkCount;
+
+    // 3. 计算各块在合并结果中的起始偏移
+    struct Offsets
+    {
+        size_t v, vt, vn, corner;
+    };
+    std::vector<Offsets> offsets(chunkCount + 1);
+    offsets[0] = {0, 0, 0, 0};
+    for (size_t i = 0; i < chunkCount; i++)
+    {
+        offsets[i + 1].v = offsets[i].v + chunks[i].positions.size();
+        offsets[i + 1].vt = offsets[i].vt + chunks[i].texCoords.size();
+        offsets[i + 1].vn = offsets[i].vn + chunks[i].normals.size();
+        offsets[i + 1].corner = offsets[i].corner + chunks[i].corners.size();
+    }
+
+    // 4. 并行拷贝到合并数组，同时修正负下标
+    out.positions.resize(offsets[chunkCount].v);
+    out.texCoords.resize(offsets[chunkCount].vt);
+    out.normals.resize(offsets[chunkCount].vn);
+    out.corners.resize(offsets[chunkCount].corner);
+
+    pool.ParallelFor(chunkCount, [&](size_t i)
+                     {
+        const ObjData &chunk = chunks[i];
+        const Offsets &o = offsets[i];
+        std::copy(chunk.positions.begin(), chunk.positions.end(), out.positions.begin() + o.v);
+        std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), out.texCoords.begin() + o.vt);
+        std::copy(chunk.normals.begin(), chunk.normals.end(), out.normals.begin() + o.vn);
+        std::copy(chunk.corners.begin(), chunk.corners.end(), out.corners.begin() + o.corner);
+        FixupCorners(out.corners.data() + o.corner, chunk.corners.size(),
+                     static_cast<int>(o.v), static_cast<int>(o.vt), static_cast<int>(o.vn));
+        // 尽早释放块内存，降低峰值占用
+        chunks[i] = ObjData(); });
+
+    return chunkCount;
+}
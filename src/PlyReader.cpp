@@ -0,0 +1,689 @@
+#include "PlyReader.h"
+#include "ImportProgress.h"
+#include "NormalGenerator.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace
+{
+    // 进度汇报与取消检查的间隔（记录数）
+    const size_t PROGRESS_STEP_RECORDS = 1 << 18;
+
+    enum class PlyType
+    {
+        Invalid,
+        Int8,
+        UInt8,
+        Int16,
+        UInt16,
+        Int32,
+        UInt32,
+        Float32,
+        Float64
+    };
+
+    enum class PlyFormat
+    {
+        Ascii,
+        BinaryLittleEndian,
+        BinaryBigEndian
+    };
+
+    struct PlyProperty
+    {
+        std::string name;
+        PlyType type = PlyType::Invalid; // 列表属性为元素类型
+        bool isList = false;
+        PlyType countType = PlyType::Invalid;
+    };
+
+    struct PlyElement
+    {
+        std::string name;
+        size_t count = 0;
+        std::vector<PlyProperty> properties;
+    };
+
+    struct PlyHeader
+    {
+        PlyFormat format = PlyFormat::Ascii;
+        std::vector<PlyElement> elements;
+        size_t bodyOffset = 0;
+    };
+
+    // Vertex 中可由 PLY 属性填充的分量，顺序与 Vertex 的内存布局一致
+    enum VertexSlot
+    {
+        SLOT_X,
+        SLOT_Y,
+        SLOT_Z,
+        SLOT_NX,
+        SLOT_NY,
+        SLOT_NZ,
+        SLOT_U,
+        SLOT_V,
+        SLOT_COUNT
+    };
+    static_assert(sizeof(Vertex) == SLOT_COUNT * sizeof(float), "Vertex layout must match VertexSlot");
+
+    size_t TypeSize(PlyType type)
+    {
+        switch (type)
+        {
+        case PlyType::Int8:
+        case PlyType::UInt8:
+            return 1;
+        case PlyType::Int16:
+        case PlyType::UInt16:
+            return 2;
+        case PlyType::Int32:
+        case PlyType::UInt32:
+        case PlyType::Float32:
+            return 4;
+        case PlyType::Float64:
+            return 8;
+        default:
+            return 0;
+        }
+    }
+
+    PlyType ParseType(const std::string &name)
+    {
+        if (name == "char" || name == "int8")
+            return PlyType::Int8;
+        if (name == "uchar" || name == "uint8")
+            return PlyType::UInt8;
+        if (name == "short" || name == "int16")
+            return PlyType::Int16;
+        if (name == "ushort" || name == "uint16")
+            return PlyType::UInt16;
+        if (name == "int" || name == "int32")
+            return PlyType::Int32;
+        if (name == "uint" || name == "uint32")
+            return PlyType::UInt32;
+        if (name == "float" || name == "float32")
+            return PlyType::Float32;
+        if (name == "double" || name == "float64")
+            return PlyType::Float64;
+        return PlyType::Invalid;
+    }
+
+    int SlotOf(const std::string &name)
+    {
+        static const char *const names[][4] = {
+            {"x", nullptr, nullptr, nullptr},
+            {"y", nullptr, nullptr, nullptr},
+            {"z", nullptr, nullptr, nullptr},
+            {"nx", nullptr, nullptr, nullptr},
+            {"ny", nullptr, nullptr, nullptr},
+            {"nz", nullptr, nullptr, nullptr},
+            {"u", "s", "texture_u", "texture_s"},
+            {"v", "t", "texture_v", "texture_t"},
+        };
+        for (int slot = 0; slot < SLOT_COUNT; slot++)
+            for (const char *alias : names[slot])
+                if (alias && name == alias)
+                    return slot;
+        return -1;
+    }
+
+    bool IsIndexList(const PlyProperty &property)
+    {
+        return property.isList && (property.name == "vertex_indices" || property.name == "vertex_index");
+    }
+
+    // 按空白切分一行
+    std::vector<std::string> Tokenize(const char *begin, const char *end)
+    {
+        std::vector<std::string> tokens;
+        const char *p = begin;
+        while (p < end)
+        {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+                ++p;
+            const char *start = p;
+            while (p < end && *p != ' ' && *p != '\t' && *p != '\r')
+                ++p;
+            if (p > start)
+                tokens.emplace_back(start, p);
+        }
+        return tokens;
+    }
+
+    bool ParseHeader(const char *data, size_t size, PlyHeader &header)
+    {
+        const char *p = data;
+        const char *end = data + size;
+        bool hasFormat = false;
+
+        while (p < end)
+        {
+            const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', end - p));
+            if (!lineEnd)
+                return false;
+            std::vector<std::string> tokens = Tokenize(p, lineEnd);
+            p = lineEnd + 1;
+            if (tokens.empty() || tokens[0] == "ply" || tokens[0] == "comment" || tokens[0] == "obj_info")
+                continue;
+
+            if (tokens[0] == "end_header")
+            {
+                header.bodyOffset = static_cast<size_t>(p - data);
+                return hasFormat;
+            }
+            if (tokens[0] == "format" && tokens.size() >= 2)
+            {
+                if (tokens[1] == "ascii")
+                    header.format = PlyFormat::Ascii;
+                else if (tokens[1] == "binary_little_endian")
+                    header.format = PlyFormat::BinaryLittleEndian;
+                else if (tokens[1] == "binary_big_endian")
+                    header.format = PlyFormat::BinaryBigEndian;
+                else
+                    return false;
+                hasFormat = true;
+            }
+            else if (tokens[0] == "element" && tokens.size() >= 3)
+            {
+                PlyElement element;
+                element.name = tokens[1];
+                element.count = static_cast<size_t>(std::strtoull(tokens[2].c_str(), nullptr, 10));
+                header.elements.push_back(element);
+            }
+            else if (tokens[0] == "property" && !header.elements.empty())
+            {
+                PlyProperty property;
+                if (tokens.size() >= 5 && tokens[1] == "list")
+                {
+                    property.isList = true;
+                    property.countType = ParseType(tokens[2]);
+                    property.type = ParseType(tokens[3]);
+                    property.name = tokens[4];
+                    if (property.countType == PlyType::Invalid)
+                        return false;
+                }
+                else if (tokens.size() >= 3)
+                {
+                    property.type = ParseType(tokens[1]);
+                    property.name = tokens[2];
+                }
+                if (property.type == PlyType::Invalid)
+                    return false;
+                header.elements.back().properties.push_back(property);
+            }
+        }
+        return false;
+    }
+
+    bool HostIsLittleEndian()
+    {
+        const uint16_t probe = 1;
+        unsigned char first;
+        std::memcpy(&first, &probe, 1);
+        return first == 1;
+    }
+
+    // 读取一个二进制标量（未对齐，按需翻转字节序）
+    double LoadScalar(const char *p, PlyType type, bool swap)
+    {
+        unsigned char bytes[8];
+        size_t n = TypeSize(type);
+        std::memcpy(bytes, p, n);
+        if (swap)
+            std::reverse(bytes, bytes + n);
+        switch (type)
+        {
+        case PlyType::Int8:
+        {
+            int8_t v;
+            std::memcpy(&v, bytes, sizeof(v));
+            return v;
+        }
+        case PlyType::UInt8:
+            return bytes[0];
+        case PlyType::Int16:
+        {
+            int16_t v;
+            std::memcpy(&v, bytes, sizeof(v));
+            return v;
+        }
+        case PlyType::UInt16:
+        {
+            uint16_t v;
+            std::memcpy(&v, bytes, sizeof(v));
+            return v;
+        }
+        case PlyType::Int32:
+        {
+            int32_t v;
+            std::memcpy(&v, bytes, sizeof(v));
+            return v;
+        }
+        case PlyType::UInt32:
+        {
+            uint32_t v;
+            std::memcpy(&v, bytes, sizeof(v));
+            return v;
+        }
+        case PlyType::Float32:
+        {
+            float v;
+            std::memcpy(&v, bytes, sizeof(v));
+            return v;
+        }
+        case PlyType::Float64:
+        {
+            double v;
+            std::memcpy(&v, bytes, sizeof(v));
+            return v;
+        }
+        default:
+            return 0.0;
+        }
+    }
+
+    // 多边形按扇形三角化
+    void EmitPolygon(const std::vector<unsigned int> &polygon, std::vector<unsigned int> &indices)
+    {
+        for (size_t i = 1; i + 1 < polygon.size(); i++)
+        {
+            indices.push_back(polygon[0]);
+            indices.push_back(polygon[i]);
+            indices.push_back(polygon[i + 1]);
+        }
+    }
+
+    bool ReportProgress(ImportProgress *progress, size_t record, const char *p, const char *data, size_t size)
+    {
+        if (!progress || record % PROGRESS_STEP_RECORDS != 0)
+            return true;
+        if (progress->IsCancelled())
+            return false;
+        progress->Report(static_cast<float>(p - data) / static_cast<float>(size));
+        return true;
+    }
+
+    class BinaryBody
+    {
+    public:
+        BinaryBody(const char *data, size_t size, size_t offset, bool swap, ImportProgress *progress)
+            : data(data), size(size), p(data + offset), end(data + size), swap(swap), progress(progress)
+        {
+        }
+
+        // 未读取的字节数；每个面至少占 1 字节，用它限制按文件头数量预留的内存
+        size_t Remaining() const { return static_cast<size_t>(end - p); }
+
+        bool ReadVertices(const PlyElement &element, std::vector<Vertex> &vertices)
+        {
+            int offsets[SLOT_COUNT];
+            PlyType types[SLOT_COUNT];
+            std::fill(offsets, offsets + SLOT_COUNT, -1);
+            std::fill(types, types + SLOT_COUNT, PlyType::Invalid);
+            size_t stride = 0;
+            bool allFloat = true;
+            for (const PlyProperty &property : element.properties)
+            {
+                // 顶点元素带列表属性时记录不定长，这里不支持
+                if (property.isList)
+                    return false;
+                int slot = SlotOf(property.name);
+                if (slot >= 0)
+                {
+                    offsets[slot] = static_cast<int>(stride);
+                    types[slot] = property.type;
+                    allFloat = allFloat && property.type == PlyType::Float32;
+                }
+                stride += TypeSize(property.type);
+            }
+            if (stride == 0 || element.count > static_cast<size_t>(end - p) / stride)
+                return false;
+
+            vertices.resize(element.count);
+            bool exactLayout = !swap && stride == sizeof(Vertex);
+            for (int slot = 0; slot < SLOT_COUNT; slot++)
+                exactLayout = exactLayout && offsets[slot] == slot * static_cast<int>(sizeof(float)) &&
+                              types[slot] == PlyType::Float32;
+
+            if (exactLayout)
+            {
+                // 与 Vertex 逐字节一致：整块拷贝
+                std::memcpy(vertices.data(), p, element.count * stride);
+            }
+            else if (!swap && allFloat)
+            {
+                for (size_t i = 0; i < element.count; i++)
+                {
+                    if (!ReportProgress(progress, i, p, data, size))
+                        return false;
+                    float values[SLOT_COUNT] = {};
+                    for (int slot = 0; slot < SLOT_COUNT; slot++)
+                        if (offsets[slot] >= 0)
+                            std::memcpy(&values[slot], p + offsets[slot], sizeof(float));
+                    std::memcpy(&vertices[i], values, sizeof(values));
+                    p += stride;
+                }
+                return true;
+            }
+            else
+            {
+                for (size_t i = 0; i < element.count; i++)
+                {
+                    if (!ReportProgress(progress, i, p, data, size))
+                        return false;
+                    float values[SLOT_COUNT] = {};
+                    for (int slot = 0; slot < SLOT_COUNT; slot++)
+                        if (offsets[slot] >= 0)
+                            values[slot] = static_cast<float>(LoadScalar(p + offsets[slot], types[slot], swap));
+                    std::memcpy(&vertices[i], values, sizeof(values));
+                    p += stride;
+                }
+                return true;
+            }
+            p += element.count * stride;
+            return true;
+        }
+
+        // indices 为空指针时只跳过该元素
+        bool ReadFaces(const PlyElement &element, std::vector<unsigned int> *indices)
+        {
+            // 常见布局（只有一个 uchar 计数的 int/uint 列表）走专门的循环
+            if (indices && !swap && element.properties.size() == 1 && IsIndexList(element.properties[0]) &&
+                TypeSize(element.properties[0].countType) == 1 && TypeSize(element.properties[0].type) == 4)
+                return ReadTriangleList(element, *indices);
+
+            std::vector<unsigned int> polygon;
+            for (size_t i = 0; i < element.count; i++)
+            {
+                if (!ReportProgress(progress, i, p, data, size))
+                    return false;
+                for (const PlyProperty &property : element.properties)
+                {
+                    if (!property.isList)
+                    {
+                        size_t bytes = TypeSize(property.type);
+                        if (static_cast<size_t>(end - p) < bytes)
+                            return false;
+                        p += bytes;
+                        continue;
+                    }
+
+                    size_t countBytes = TypeSize(property.countType);
+                    size_t itemBytes = TypeSize(property.type);
+                    if (static_cast<size_t>(end - p) < countBytes)
+                        return false;
+                    double count = LoadScalar(p, property.countType, swap);
+                    p += countBytes;
+                    if (count < 0.0 || count > static_cast<double>(end - p) / itemBytes)
+                        return false;
+                    size_t n = static_cast<size_t>(count);
+
+                    if (indices && IsIndexList(property))
+                    {
+                        polygon.clear();
+                        for (size_t k = 0; k < n; k++)
+                            polygon.push_back(static_cast<unsigned int>(LoadScalar(p + k * itemBytes, property.type, swap)));
+                        EmitPolygon(polygon, *indices);
+                    }
+                    p += n * itemBytes;
+                }
+            }
+            return true;
+        }
+
+    private:
+        const char *data;
+        size_t size;
+        const char *p;
+        const char *end;
+        bool swap;
+        ImportProgress *progress;
+
+        bool ReadTriangleList(const PlyElement &element, std::vector<unsigned int> &indices)
+        {
+            std::vector<unsigned int> polygon;
+            for (size_t i = 0; i < element.count; i++)
+            {
+                if (!ReportProgress(progress, i, p, data, size))
+                    return false;
+                if (p >= end)
+                    return false;
+                size_t n = static_cast<unsigned char>(*p++);
+                if (static_cast<size_t>(end - p) < n * 4)
+                    return false;
+                if (n == 3)
+                {
+                    unsigned int tri[3];
+                    std::memcpy(tri, p, sizeof(tri));
+                    indices.insert(indices.end(), tri, tri + 3);
+                }
+                else
+                {
+                    polygon.resize(n);
+                    if (n > 0)
+                        std::memcpy(polygon.data(), p, n * 4);
+                    EmitPolygon(polygon, indices);
+                }
+                p += n * 4;
+            }
+            return true;
+        }
+    };
+
+    class AsciiBody
+    {
+    public:
+        AsciiBody(const char *data, size_t size, size_t offset, ImportProgress *progress)
+            : data(data), size(size), p(data + offset), end(data + size), progress(progress)
+        {
+        }
+
+        // 未读取的字节数；每个面至少占 1 字节，用它限制按文件头数量预留的内存
+        size_t Remaining() const { return static_cast<size_t>(end - p); }
+
+        bool ReadVertices(const PlyElement &element, std::vector<Vertex> &vertices)
+        {
+            // 每个数值至少占 2 字节（数字与分隔符），分配前按剩余数据校验文件头给出的数量
+            const size_t valuesPerRecord = std::max<size_t>(element.properties.size(), 1);
+            if (element.count > MaxValues() / valuesPerRecord)
+                return false;
+
+            vertices.resize(element.count);
+            for (size_t i = 0; i < element.count; i++)
+            {
+                if (!ReportProgress(progress, i, p, data, size))
+                    return false;
+                float values[SLOT_COUNT] = {};
+                for (const PlyProperty &property : element.properties)
+                {
+                    double value;
+                    if (!Next(value))
+                        return false;
+                    if (property.isList)
+                    {
+                        // 顶点上的列表属性（少见）：读出后丢弃
+                        size_t n;
+                        if (!ListCount(value, n))
+                            return false;
+                        for (size_t k = 0; k < n; k++)
+                        {
+                            double item;
+                            if (!Next(item))
+                                return false;
+                        }
+                        continue;
+                    }
+                    int slot = SlotOf(property.name);
+                    if (slot >= 0)
+                        values[slot] = static_cast<float>(value);
+                }
+                std::memcpy(&vertices[i], values, sizeof(values));
+            }
+            return true;
+        }
+
+        bool ReadFaces(const PlyElement &element, std::vector<unsigned int> *indices)
+        {
+            std::vector<unsigned int> polygon;
+            for (size_t i = 0; i < element.count; i++)
+            {
+                if (!ReportProgress(progress, i, p, data, size))
+                    return false;
+                for (const PlyProperty &property : element.properties)
+                {
+                    double value;
+                    if (!Next(value))
+                        return false;
+                    if (!property.isList)
+                        continue;
+                    size_t n;
+                    if (!ListCount(value, n))
+                        return false;
+                    polygon.clear();
+                    for (size_t k = 0; k < n; k++)
+                    {
+                        double item;
+                        if (!Next(item))
+                            return false;
+                        polygon.push_back(static_cast<unsigned int>(item));
+                    }
+                    if (indices && IsIndexList(property))
+                        EmitPolygon(polygon, *indices);
+                }
+            }
+            return true;
+        }
+
+    private:
+        const char *data;
+        size_t size;
+        const char *p;
+        const char *end;
+        ImportProgress *progress;
+
+        // 剩余数据最多还能容纳的数值个数（最后一个数值后可以没有分隔符）
+        size_t MaxValues() const { return (static_cast<size_t>(end - p) + 1) / 2; }
+
+        // 列表长度须为非负整数，且不超过剩余数据能容纳的数值个数（NaN 也在这里被拒绝）
+        bool ListCount(double value, size_t &n) const
+        {
+            if (!(value >= 0.0) || value > static_cast<double>(MaxValues()) ||
+                value != static_cast<double>(static_cast<size_t>(value)))
+                return false;
+            n = static_cast<size_t>(value);
+            return true;
+        }
+
+        // 读取下一个数值（按空白分隔，不区分行）
+        bool Next(double &value)
+        {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+                ++p;
+            if (p < end && *p == '+')
+                ++p;
+            auto result = std::from_chars(p, end, value);
+            if (result.ec != std::errc())
+                return false;
+            p = result.ptr;
+            return true;
+        }
+    };
+
+    template <typename Body>
+    bool ReadBody(Body &body, const PlyHeader &header, std::vector<Vertex> &vertices, std::vector<unsigned int> &indices)
+    {
+        bool haveVertices = false;
+        for (const PlyElement &element : header.elements)
+        {
+            if (element.name == "vertex" && !haveVertices)
+            {
+                if (!body.ReadVertices(element, vertices))
+                    return false;
+                haveVertices = true;
+            }
+            else if (element.name == "face")
+            {
+                indices.reserve(indices.size() + std::min(element.count, body.Remaining()) * 3);
+                if (!body.ReadFaces(element, &indices))
+                    return false;
+            }
+            else if (!body.ReadFaces(element, nullptr))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+bool PlyReader::IsPly(const char *data, size_t size)
+{
+    return size >= 4 && std::memcmp(data, "ply", 3) == 0 && (data[3] == '\n' || data[3] == '\r');
+}
+
+bool PlyReader::Read(const char *data, size_t size, std::vector<Vertex> &vertices, std::vector<unsigned int> &indices,
+                     ImportProgress *progress)
+{
+    PlyHeader header;
+    if (!IsPly(data, size) || !ParseHeader(data, size, header))
+    {
+        std::cerr << "[PlyReader] Invalid PLY header" << std::endl;
+        return false;
+    }
+
+    bool hasNormals = false;
+    for (const PlyElement &element : header.elements)
+        if (element.name == "vertex")
+            for (const PlyProperty &property : element.properties)
+                hasNormals = hasNormals || SlotOf(property.name) == SLOT_NX;
+
+    bool completed;
+    if (header.format == PlyFormat::Ascii)
+    {
+        AsciiBody body(data, size, header.bodyOffset, progress);
+        completed = ReadBody(body, header, vertices, indices);
+    }
+    else
+    {
+        bool swap = (header.format == PlyFormat::BinaryLittleEndian) != HostIsLittleEndian();
+        BinaryBody body(data, size, header.bodyOffset, swap, progress);
+        completed = ReadBody(body, header, vertices, indices);
+    }
+    if (!completed)
+    {
+        if (!progress || !progress->IsCancelled())
+            std::cerr << "[PlyReader] Truncated or unsupported PLY data" << std::endl;
+        return false;
+    }
+
+    // 丢弃引用越界顶点的三角形
+    size_t kept = 0;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        if (indices[i] >= vertices.size() || indices[i + 1] >= vertices.size() || indices[i + 2] >= vertices.size())
+            continue;
+        indices[kept++] = indices[i];
+        indices[kept++] = indices[i + 1];
+        indices[kept++] = indices[i + 2];
+    }
+    if (kept < indices.size())
+        std::cerr << "[PlyReader] Dropped " << (indices.size() - kept) / 3 << " triangles with invalid indices"
+                  << std::endl;
+    indices.resize(kept);
+    if (indices.empty())
+        return false;
+
+    if (!hasNormals)
+        NormalGenerator::Generate(vertices, indices, ThreadPool::Global());
+
+    std::cout << "[PlyReader] " << (header.format == PlyFormat::Ascii ? "ASCII" : "Binary") << " PLY: "
+              << vertices.size() << " vertices, " << indices.size() / 3 << " triangles"
+              << (hasNormals ? "" : " (normals generated)") << std::endl;
+    return true;
+}
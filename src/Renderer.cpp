@@ -1,4 +1,8 @@
 #include "Renderer.h"
+#include "InstanceBatcher.h"
+#include "VertexFormat.h"
+#include <algorithm>
+#include <cmath>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -10,6 +14,23 @@ namespace PartC
     unsigned int Renderer::shadowMap;
     Shader *Renderer::depthShader = nullptr;
     glm::mat4 Renderer::lightSpaceMatrix;
+    glm::vec3 Renderer::shadowCenter = glm::vec3(0.0f);
+    float Renderer::shadowRadius = 10.0f;
+    float Renderer::lodErrorPixels = 1.0f;
+    glm::vec3 Renderer::lodViewPosition = glm::vec3(0.0f);
+    float Renderer::lodPixelsPerUnit = 1.0f;
+    bool Renderer::clusterCulling = true;
+    glm::mat4 Renderer::viewProjection = glm::mat4(1.0f);
+    size_t Renderer::trianglesDrawn = 0;
+    size_t Renderer::clustersDrawn = 0;
+    size_t Renderer::clustersTested = 0;
+    bool Renderer::instancing = true;
+    size_t Renderer::instancedDraws = 0;
+    size_t Renderer::instancesDrawn = 0;
+    bool Renderer::multiDrawIndirect = true;
+    size_t Renderer::indirectSubmits = 0;
+    size_t Renderer::indirectCommands = 0;
+    glm::vec4 Renderer::frustumPlanes[6];
 
     void Renderer::InitShadowMap()
     {
@@ -32,21 +53,30 @@ namespace PartC
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
         depthShader = new Shader("assets/shaders/shadow_depth.vert", "assets/shaders/shadow_depth.frag");
+        VertexFormat::CheckProgram<PositionVertex>(depthShader->ID, "shadow depth");
+        VertexFormat::CheckProgram<InstanceData>(depthShader->ID, "shadow depth");
+    }
+
+    void Renderer::FitShadowBounds(const glm::vec3 &center, float radius)
+    {
+        shadowCenter = center;
+        shadowRadius = std::max(radius, 0.1f);
     }
 
     void Renderer::BeginShadowMap()
     {
         glm::mat4 lightProjection, lightView;
-        float near_plane = 1.0f, far_plane = 20.0f;
+        // [新增] 正交范围与深度范围恰好包住场景包围球，阴影贴图的分辨率不浪费在空白区域
+        float near_plane = 1.0f, far_plane = near_plane + 2.0f * shadowRadius;
         // Orthographic projection for directional light
-        lightProjection = glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, near_plane, far_plane);
+        lightProjection = glm::ortho(-shadowRadius, shadowRadius, -shadowRadius, shadowRadius, near_plane, far_plane);
 
         // Look from light direction
         // Note: direction is usually pointing FROM light TO object, so we negate it to get position
         // But here we assume direction is direction vector.
         // Let's assume light is far away.
-        glm::vec3 lightPos = -mainLight.direction * 10.0f;
-        lightView = glm::lookAt(lightPos, glm::vec3(0.0f), glm::vec3(0.0, 1.0, 0.0));
+        glm::vec3 lightPos = shadowCenter - glm::normalize(mainLight.direction) * (shadowRadius + near_plane);
+        lightView = glm::lookAt(lightPos, shadowCenter, glm::vec3(0.0, 1.0, 0.0));
         lightSpaceMatrix = lightProjection * lightView;
 
         depthShader->use();
@@ -63,7 +93,8 @@ namespace PartC
         glViewport(0, 0, scrWidth, scrHeight);
     }
 
-    void Renderer::RenderMesh(Mesh *mesh, Shader &shader, const glm::mat4 &modelMatrix)
+    void Renderer::RenderMesh(Mesh *mesh, Shader &shader, const glm::mat4 &modelMatrix,
+                              const Material *material)
     {
         shader.use();
         shader.setMat4("model", modelMatrix);
@@ -75,10 +106,78 @@ namespace PartC
 
         if (mesh)
         {
-            mesh->Draw(shader);
+            int lod = SelectLod(mesh, modelMatrix);
+            if (lod == 0 && clusterCulling && !mesh->meshlets.empty())
+            {
+                // 视锥平面与相机都变换到模型局部空间，簇的包围数据无需变换
+                glm::vec4 planes[6];
+                MeshletBuilder::ExtractFrustumPlanes(viewProjection * modelMatrix, planes);
+                glm::vec3 cameraLocal = glm::vec3(glm::inverse(modelMatrix) * glm::vec4(lodViewPosition, 1.0f));
+                unsigned int visibleTriangles = 0;
+                clustersDrawn += mesh->DrawClusters(shader, planes, cameraLocal, visibleTriangles, material);
+                clustersTested += mesh->meshlets.size();
+                trianglesDrawn += visibleTriangles;
+            }
+            else
+            {
+                trianglesDrawn += mesh->LodIndexCount(lod) / 3;
+                mesh->Draw(shader, lod, material);
+            }
         }
     }
 
+    void Renderer::BeginFrame(const glm::vec3 &viewPos, const glm::mat4 &viewProj, float fovYRadians, int viewportHeight)
+    {
+        Material::BeginFrame();
+        lodViewPosition = viewPos;
+        viewProjection = viewProj;
+        lodPixelsPerUnit = viewportHeight / (2.0f * std::tan(fovYRadians * 0.5f));
+        trianglesDrawn = 0;
+        clustersDrawn = 0;
+        clustersTested = 0;
+        instancedDraws = 0;
+        instancesDrawn = 0;
+        indirectSubmits = 0;
+        indirectCommands = 0;
+        MeshletBuilder::ExtractFrustumPlanes(viewProj, frustumPlanes);
+    }
+
+    bool Renderer::IsVisible(const Mesh *mesh, const glm::mat4 &modelMatrix)
+    {
+        glm::vec3 center;
+        float radius;
+        mesh->bounds.WorldSphere(modelMatrix, center, radius);
+        for (int i = 0; i < 6; i++)
+            if (glm::dot(glm::vec3(frustumPlanes[i]), center) + frustumPlanes[i].w < -radius)
+                return false;
+        return true;
+    }
+
+    int Renderer::SelectLod(const Mesh *mesh, const glm::mat4 &modelMatrix)
+    {
+        if (!mesh || mesh->LodCount() <= 1)
+            return 0;
+
+        // 距离取到包围球表面；误差仍以包围盒对角线为单位（与 MeshSimplifier 一致）
+        glm::vec3 center;
+        float radius;
+        mesh->bounds.WorldSphere(modelMatrix, center, radius);
+        float scale = std::max(glm::length(glm::vec3(modelMatrix[0])),
+                               std::max(glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2]))));
+        float diagonal = glm::length(mesh->bounds.Size()) * scale;
+        float distance = glm::distance(center, lodViewPosition) - radius;
+        if (distance <= 0.0f)
+            return 0;
+
+        // 误差是相对对角线的比例，乘以对角线的投影长度即为屏幕上的误差
+        float projectedSize = diagonal / distance * lodPixelsPerUnit;
+        int lod = 0;
+        for (int i = 1; i < mesh->LodCount(); i++)
+            if (mesh->lods[i].error * projectedSize <= lodErrorPixels)
+                lod = i;
+        return lod;
+    }
+
     void Renderer::SetupLights(Shader &shader, const glm::vec3 &camPos)
     {
         shader.use();
@@ -1,29 +1,42 @@
 #include "SceneContext.h"
+#include "StreamingImporter.h"
+#include "DynamicMesh.h"
 #include <glm/gtc/matrix_transform.hpp>
 
 SceneContext::SceneContext() {}
 
 SceneContext::~SceneContext() {
     for (auto obj : objects) {
-        delete obj->mesh; // 释放 Mesh 内存
+        // 网格由句柄管理，最后一个引用释放时删除
+        delete obj->chunkedMesh;
+        delete obj->dynamicMesh;
         delete obj;
     }
     objects.clear();
 }
 
+glm::mat4 SceneObject::ModelMatrix() const {
+    glm::mat4 model = glm::mat4(1.0f);
+    model = glm::translate(model, position);
+    model = glm::rotate(model, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+    model = glm::rotate(model, glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+    model = glm::rotate(model, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+    model = glm::scale(model, scale);
+    return model;
+}
+
 void SceneContext::AddObject(SceneObject* obj) {
     objects.push_back(obj);
 }
 
+const Material* SceneContext::MaterialOf(const SceneObject* obj) {
+    return obj->textures.empty() ? nullptr : &obj->material;
+}
+
 void SceneContext::DrawAll(Shader& shader) {
     for (auto obj : objects) {
         // 计算 Model 矩阵 [Part A 核心逻辑]
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, obj->position);
-        model = glm::rotate(model, glm::radians(obj->rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-        model = glm::rotate(model, glm::radians(obj->rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-        model = glm::rotate(model, glm::radians(obj->rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-        model = glm::scale(model, obj->scale);
+        glm::mat4 model = obj->ModelMatrix();
 
         // 设置 Shader Uniforms
         shader.setMat4("model", model);
@@ -31,7 +44,7 @@ void SceneContext::DrawAll(Shader& shader) {
 
         // 绘制
         if (obj->mesh) {
-            obj->mesh->Draw(shader);
+            obj->mesh->Draw(shader, 0, MaterialOf(obj));
         }
     }
 }
\ No newline at end of file
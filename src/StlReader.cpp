@@ -0,0 +1,175 @@
+#include "StlReader.h"
+#include "ImportProgress.h"
+#include "NormalGenerator.h"
+#include "ThreadPool.h"
+#include "TripletHashMap.h"
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+    // 进度汇报与取消检查的间隔（三角形数）
+    const size_t PROGRESS_STEP_TRIANGLES = 1 << 18;
+
+    inline uint32_t FloatBits(float f)
+    {
+        // 加 0 把 -0.0 规整为 +0.0，避免相同位置被当作不同位置
+        f += 0.0f;
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        return bits;
+    }
+
+    // 按位置焊接：位模式完全相同的坐标共享一个顶点
+    struct Welder
+    {
+        TripletHashMap positionMap;
+        std::vector<Vertex> &vertices;
+        std::vector<unsigned int> &indices;
+
+        Welder(size_t triangleCount, std::vector<Vertex> &vertices, std::vector<unsigned int> &indices)
+            : positionMap(triangleCount / 2), vertices(vertices), indices(indices)
+        {
+            // 封闭网格的顶点数约为三角形数的一半
+            vertices.reserve(triangleCount / 2);
+            indices.reserve(triangleCount * 3);
+        }
+
+        void Add(const float *p)
+        {
+            unsigned int next = static_cast<unsigned int>(vertices.size());
+            unsigned int index = positionMap.FindOrInsert(FloatBits(p[0]), FloatBits(p[1]), FloatBits(p[2]), next);
+            if (index == next)
+            {
+                Vertex vertex;
+                vertex.Position = glm::vec3(p[0], p[1], p[2]);
+                vertex.Normal = glm::vec3(0.0f);
+                vertex.TexCoords = glm::vec2(0.0f);
+                vertices.push_back(vertex);
+            }
+            indices.push_back(index);
+        }
+    };
+
+    bool ReadBinary(const char *data, Welder &welder, size_t triangleCount, ImportProgress *progress)
+    {
+        const char *record = data + StlReader::HEADER_BYTES;
+        for (size_t t = 0; t < triangleCount; t++, record += StlReader::TRIANGLE_BYTES)
+        {
+            if (progress && t % PROGRESS_STEP_TRIANGLES == 0)
+            {
+                if (progress->IsCancelled())
+                    return false;
+                progress->Report(static_cast<float>(t) / static_cast<float>(triangleCount));
+            }
+
+            // 记录布局：面法线 3 float、三个顶点 9 float、2 字节属性；记录未对齐，先拷出
+            // 文件中的面法线常为 0 或与绕序不一致，不使用
+            float corners[9];
+            std::memcpy(corners, record + 12, sizeof(corners));
+            welder.Add(&corners[0]);
+            welder.Add(&corners[3]);
+            welder.Add(&corners[6]);
+        }
+        return true;
+    }
+
+    bool ReadAscii(const char *data, size_t size, Welder &welder, ImportProgress *progress)
+    {
+        const char *p = data;
+        const char *end = data + size;
+        const char *lastReport = p;
+        float corner[3];
+
+        while (p < end)
+        {
+            // 只关心 "vertex x y z" 行，solid / facet / outer loop 等关键字直接跳过
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+                ++p;
+            if (end - p > 6 && std::memcmp(p, "vertex", 6) == 0 && (p[6] == ' ' || p[6] == '\t'))
+            {
+                p += 6;
+                for (int k = 0; k < 3; k++)
+                {
+                    while (p < end && (*p == ' ' || *p == '\t'))
+                        ++p;
+                    if (p < end && *p == '+')
+                        ++p;
+                    auto result = std::from_chars(p, end, corner[k]);
+                    if (result.ec != std::errc())
+                        return false;
+                    p = result.ptr;
+                }
+                welder.Add(corner);
+            }
+            while (p < end && *p != '\n')
+                ++p;
+
+            if (progress && p - lastReport > (16 << 20))
+            {
+                if (progress->IsCancelled())
+                    return false;
+                progress->Report(static_cast<float>(p - data) / static_cast<float>(size));
+                lastReport = p;
+            }
+        }
+
+        // 每个 facet 恰好 3 个顶点，多余的角点说明文件损坏
+        if (welder.indices.size() % 3 != 0)
+            return false;
+        return true;
+    }
+}
+
+bool StlReader::IsBinary(const char *data, size_t size)
+{
+    if (size < HEADER_BYTES)
+        return false;
+    uint32_t triangleCount;
+    std::memcpy(&triangleCount, data + 80, sizeof(triangleCount));
+    uint64_t expected = HEADER_BYTES + static_cast<uint64_t>(triangleCount) * TRIANGLE_BYTES;
+    if (size == expected)
+        return true;
+    // 部分导出工具会在末尾追加数据；此时只接受不以 "solid" 开头的文件
+    return size > expected && std::memcmp(data, "solid", 5) != 0;
+}
+
+bool StlReader::Read(const char *data, size_t size, std::vector<Vertex> &vertices, std::vector<unsigned int> &indices,
+                     ImportProgress *progress)
+{
+    bool binary = IsBinary(data, size);
+    size_t triangleCount = 0;
+    if (binary)
+    {
+        uint32_t declared;
+        std::memcpy(&declared, data + 80, sizeof(declared));
+        triangleCount = declared;
+    }
+    else
+    {
+        // ASCII 每个三角形约 250 字节，仅用于预分配
+        triangleCount = size / 256;
+    }
+
+    Welder welder(triangleCount, vertices, indices);
+    bool completed = binary ? ReadBinary(data, welder, triangleCount, progress)
+                            : ReadAscii(data, size, welder, progress);
+    if (!completed)
+    {
+        if (!progress || !progress->IsCancelled())
+            std::cerr << "[StlReader] Malformed " << (binary ? "binary" : "ASCII") << " STL data" << std::endl;
+        return false;
+    }
+    if (indices.empty())
+        return false;
+
+    // 硬边（折痕角以上）两侧拆分顶点，CAD 模型的平面保持平直
+    NormalGenerator::Generate(vertices, indices, ThreadPool::Global());
+
+    std::cout << "[StlReader] " << (binary ? "Binary" : "ASCII") << " STL: " << indices.size() / 3
+              << " triangles, welded " << indices.size() << " corners -> " << vertices.size() << " vertices"
+              << std::endl;
+    return true;
+}
@@ -0,0 +1,819 @@
+#include "StreamingImporter.h"
+#include "ImportProgress.h"
+#include "IndexFormat.h"
+#include "MappedFile.h"
+#include "MeshOptimizer.h"
+#include "ObjParser.h"
+#include "TripletHashMap.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    const char MANIFEST_MAGIC[8] = {'M', 'E', 'S', 'H', 'C', 'H', 'N', 'K'};
+    const char CHUNK_MAGIC[8] = {'M', 'E', 'S', 'H', 'P', 'A', 'R', 'T'};
+    // 3: 块的顶点数不超过 65536，块文件存 16 位索引
+    const uint32_t MANIFEST_VERSION = 3;
+
+    const size_t MIN_BUDGET = 64u * 1024 * 1024;
+    const size_t SPILL_BUFFER_BYTES = 1024 * 1024;
+    // 缓存页大小同时是 12 与 8 的倍数，属性记录不会跨页
+    const size_t PAGE_BYTES = 768 * 1024;
+    const size_t MIN_CELL_BUFFER_BYTES = 64 * 1024;
+    // 第 3 阶段每个三角形的内存开销估计：单元记录 + 顶点 + 索引 + 去重表
+    const size_t CHUNK_BYTES_PER_TRIANGLE = 400;
+
+    struct ManifestHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t chunkCount;
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        float boundsMin[3];
+        float boundsMax[3];
+    };
+
+    struct ManifestEntry
+    {
+        uint64_t vertexCount;
+        uint64_t indexCount;
+        float boundsMin[3];
+        float boundsMax[3];
+    };
+
+    // 块文件：文件头后依次是顶点数组和索引数组（每个索引 indexSize 字节）
+    struct ChunkHeader
+    {
+        char magic[8];
+        uint64_t vertexCount;
+        uint64_t indexCount;
+        float boundsMin[3];
+        float boundsMax[3];
+        uint32_t indexSize;
+        uint32_t reserved;
+    };
+
+    // 块常驻显存的字节数（索引宽度由顶点数决定）
+    size_t ChunkBytes(size_t vertexCount, size_t indexCount)
+    {
+        // 交错顶点 + 几何池中的深度位置流 + 索引
+        return vertexCount * (sizeof(Vertex) + sizeof(PositionVertex)) + indexCount * IndexFormat::Size(IndexFormat::Select(vertexCount));
+    }
+
+    // 单元文件中的一个角点：去重键 + 已取出属性的顶点
+    struct CornerRecord
+    {
+        ObjIndex key;
+        Vertex vertex;
+    };
+
+    bool SeekFile(FILE *file, uint64_t offset)
+    {
+#ifdef _WIN32
+        return _fseeki64(file, static_cast<long long>(offset), SEEK_SET) == 0;
+#else
+        return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+    }
+
+    std::string ChunkPath(const std::string &dir, size_t index)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "chunk_%05zu.bin", index);
+        return (fs::path(dir) / name).string();
+    }
+
+    std::string CellPath(const std::string &dir, size_t index)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "cell_%05zu.tmp", index);
+        return (fs::path(dir) / name).string();
+    }
+
+    // 带固定大小缓冲的顺序写入
+    class SpillWriter
+    {
+    public:
+        ~SpillWriter() { Close(); }
+
+        bool Open(const std::string &path)
+        {
+            file = std::fopen(path.c_str(), "wb");
+            buffer.reserve(SPILL_BUFFER_BYTES);
+            return file != nullptr;
+        }
+
+        void Write(const void *data, size_t bytes)
+        {
+            if (buffer.size() + bytes > SPILL_BUFFER_BYTES)
+                Flush();
+            if (bytes > SPILL_BUFFER_BYTES)
+            {
+                ok = ok && std::fwrite(data, 1, bytes, file) == bytes;
+                return;
+            }
+            const char *p = static_cast<const char *>(data);
+            buffer.insert(buffer.end(), p, p + bytes);
+        }
+
+        bool Close()
+        {
+            if (file)
+            {
+                Flush();
+                ok = (std::fclose(file) == 0) && ok;
+                file = nullptr;
+            }
+            return ok;
+        }
+
+    private:
+        FILE *file = nullptr;
+        std::vector<char> buffer;
+        bool ok = true;
+
+        void Flush()
+        {
+            if (!buffer.empty())
+            {
+                ok = ok && std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+                buffer.clear();
+            }
+        }
+    };
+
+    // 随机读取溢写文件：固定页数的 LRU 缓存，内存占用与文件大小无关
+    class PagedReader
+    {
+    public:
+        PagedReader(const std::string &path, size_t budgetBytes)
+            : maxPages(std::max<size_t>(1, budgetBytes / PAGE_BYTES))
+        {
+            file = std::fopen(path.c_str(), "rb");
+        }
+
+        ~PagedReader()
+        {
+            if (file)
+                std::fclose(file);
+        }
+
+        // 返回文件 offset 处的记录（记录不跨页）
+        const char *Get(uint64_t offset)
+        {
+            uint64_t pageIndex = offset / PAGE_BYTES;
+            auto it = lookup.find(pageIndex);
+            size_t slot = (it != lookup.end()) ? it->second : Load(pageIndex);
+            pages[slot].lastUse = ++clock;
+            return pages[slot].data.data() + (offset - pageIndex * PAGE_BYTES);
+        }
+
+    private:
+        struct Page
+        {
+            uint64_t index;
+            uint64_t lastUse;
+            std::vector<char> data;
+        };
+
+        FILE *file = nullptr;
+        size_t maxPages;
+        uint64_t clock = 0;
+        std::vector<Page> pages;
+        std::unordered_map<uint64_t, size_t> lookup;
+
+        size_t Load(uint64_t pageIndex)
+        {
+            size_t slot;
+            if (pages.size() < maxPages)
+            {
+                pages.push_back(Page{0, 0, std::vector<char>(PAGE_BYTES)});
+                slot = pages.size() - 1;
+            }
+            else
+            {
+                slot = 0;
+                for (size_t i = 1; i < pages.size(); i++)
+                    if (pages[i].lastUse < pages[slot].lastUse)
+                        slot = i;
+                lookup.erase(pages[slot].index);
+            }
+
+            Page &page = pages[slot];
+            page.index = pageIndex;
+            size_t read = 0;
+            if (file && SeekFile(file, pageIndex * PAGE_BYTES))
+                read = std::fread(page.data.data(), 1, PAGE_BYTES, file);
+            std::memset(page.data.data() + read, 0, PAGE_BYTES - read);
+            lookup[pageIndex] = slot;
+            return slot;
+        }
+    };
+
+    // 单元缓冲：写满后追加到单元文件，文件只在写入时短暂打开，避免句柄数超限
+    struct CellBuffer
+    {
+        std::vector<CornerRecord> records;
+        bool hasFile = false;
+    };
+
+    bool FlushCell(const std::string &dir, size_t index, CellBuffer &cell)
+    {
+        if (cell.records.empty())
+            return true;
+        FILE *file = std::fopen(CellPath(dir, index).c_str(), cell.hasFile ? "ab" : "wb");
+        if (!file)
+            return false;
+        bool ok = std::fwrite(cell.records.data(), sizeof(CornerRecord), cell.records.size(), file) == cell.records.size();
+        ok = (std::fclose(file) == 0) && ok;
+        cell.hasFile = true;
+        cell.records.clear();
+        return ok;
+    }
+
+    // 把 records 中从 begin 起的角点记录去重为索引网格，重排后写出块文件
+    // 顶点数达到 16 位索引的上限时提前结束，end 输出已写入的位置（剩余记录由下一个块写出）
+    bool WriteChunk(const std::string &path, const std::vector<CornerRecord> &records, size_t begin, size_t &end,
+                    ManifestEntry &entry)
+    {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        std::vector<unsigned char> generatedNormal;
+        TripletHashMap cornerMap(records.size() / 4);
+        vertices.reserve(records.size() / 4);
+        indices.reserve(records.size());
+
+        size_t corner = begin;
+        for (; corner + 2 < records.size(); corner += 3)
+        {
+            if (vertices.size() + 3 > IndexFormat::MAX_SHORT_VERTICES)
+                break;
+            const CornerRecord *tri = &records[corner];
+            glm::vec3 faceNormal = glm::cross(tri[1].vertex.Position - tri[0].vertex.Position,
+                                              tri[2].vertex.Position - tri[0].vertex.Position);
+            for (int k = 0; k < 3; k++)
+            {
+                unsigned int next = static_cast<unsigned int>(vertices.size());
+                unsigned int index = cornerMap.FindOrInsert(static_cast<uint32_t>(tri[k].key.v), static_cast<uint32_t>(tri[k].key.vt),
+                                                            static_cast<uint32_t>(tri[k].key.vn), next);
+                if (index == next)
+                {
+                    vertices.push_back(tri[k].vertex);
+                    generatedNormal.push_back(tri[k].key.vn < 0 ? 1 : 0);
+                    if (tri[k].key.vn < 0)
+                        vertices.back().Normal = glm::vec3(0.0f);
+                }
+                // 缺少法线时在块内累加面积加权面法线（块边界处可能有轻微接缝）
+                if (generatedNormal[index])
+                    vertices[index].Normal += faceNormal;
+                indices.push_back(index);
+            }
+        }
+        end = corner;
+
+        glm::vec3 lo = vertices.empty() ? glm::vec3(0.0f) : vertices[0].Position;
+        glm::vec3 hi = lo;
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            if (generatedNormal[i])
+            {
+                float len = glm::length(vertices[i].Normal);
+                vertices[i].Normal = len > 0.0f ? vertices[i].Normal / len : glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+            lo = glm::min(lo, vertices[i].Position);
+            hi = glm::max(hi, vertices[i].Position);
+        }
+        MeshOptimizer::Optimize(vertices, indices, false);
+
+        ChunkHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, CHUNK_MAGIC, sizeof(CHUNK_MAGIC));
+        header.vertexCount = vertices.size();
+        header.indexCount = indices.size();
+        std::vector<uint16_t> shortIndices;
+        GLenum indexType;
+        const void *indexData = IndexFormat::Prepare(indices.data(), indices.size(), vertices.size(), shortIndices, indexType);
+        header.indexSize = static_cast<uint32_t>(IndexFormat::Size(indexType));
+        for (int k = 0; k < 3; k++)
+        {
+            header.boundsMin[k] = entry.boundsMin[k] = lo[k];
+            header.boundsMax[k] = entry.boundsMax[k] = hi[k];
+        }
+        entry.vertexCount = header.vertexCount;
+        entry.indexCount = header.indexCount;
+
+        FILE *file = std::fopen(path.c_str(), "wb");
+        if (!file)
+            return false;
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+        ok = ok && std::fwrite(vertices.data(), sizeof(Vertex), vertices.size(), file) == vertices.size();
+        ok = ok && std::fwrite(indexData, header.indexSize, indices.size(), file) == indices.size();
+        return (std::fclose(file) == 0) && ok;
+    }
+
+    bool StatSource(const std::string &path, uint64_t &size, int64_t &time)
+    {
+        std::error_code ec;
+        size = fs::file_size(path, ec);
+        if (ec)
+            return false;
+        time = static_cast<int64_t>(fs::last_write_time(path, ec).time_since_epoch().count());
+        return !ec;
+    }
+
+    bool ReadManifest(const std::string &manifestPath, ManifestHeader &header, std::vector<ManifestEntry> &entries)
+    {
+        FILE *file = std::fopen(manifestPath.c_str(), "rb");
+        if (!file)
+            return false;
+        bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+                  std::memcmp(header.magic, MANIFEST_MAGIC, sizeof(MANIFEST_MAGIC)) == 0 &&
+                  header.version == MANIFEST_VERSION;
+        if (ok)
+        {
+            entries.resize(header.chunkCount);
+            ok = std::fread(entries.data(), sizeof(ManifestEntry), entries.size(), file) == entries.size();
+        }
+        std::fclose(file);
+        return ok;
+    }
+}
+
+// ---------------- ChunkedMesh ----------------
+
+ChunkedMesh::~ChunkedMesh()
+{
+    for (auto &chunk : chunks)
+        PageOut(chunk);
+}
+
+ChunkedMesh *ChunkedMesh::LoadManifest(const std::string &manifestPath)
+{
+    ManifestHeader header;
+    std::vector<ManifestEntry> entries;
+    if (!ReadManifest(manifestPath, header, entries))
+        return nullptr;
+
+    std::string dir = fs::path(manifestPath).parent_path().string();
+    ChunkedMesh *mesh = new ChunkedMesh();
+    mesh->boundsMin = glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+    mesh->boundsMax = glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+    mesh->chunks.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        Chunk &chunk = mesh->chunks[i];
+        chunk.path = ChunkPath(dir, i);
+        chunk.boundsMin = glm::vec3(entries[i].boundsMin[0], entries[i].boundsMin[1], entries[i].boundsMin[2]);
+        chunk.boundsMax = glm::vec3(entries[i].boundsMax[0], entries[i].boundsMax[1], entries[i].boundsMax[2]);
+        chunk.vertexCount = static_cast<size_t>(entries[i].vertexCount);
+        chunk.indexCount = static_cast<size_t>(entries[i].indexCount);
+    }
+    return mesh;
+}
+
+bool ChunkedMesh::PageIn(Chunk &chunk)
+{
+    MappedFile file;
+    if (!file.Open(chunk.path) || file.Size() < sizeof(ChunkHeader))
+        return false;
+    ChunkHeader header;
+    std::memcpy(&header, file.Data(), sizeof(header));
+    if (header.indexSize != sizeof(uint16_t) && header.indexSize != sizeof(unsigned int))
+        return false;
+    size_t expected = sizeof(ChunkHeader) + header.vertexCount * sizeof(Vertex) + header.indexCount * header.indexSize;
+    if (std::memcmp(header.magic, CHUNK_MAGIC, sizeof(CHUNK_MAGIC)) != 0 || file.Size() < expected || header.indexCount == 0)
+        return false;
+
+    const Vertex *vertices = reinterpret_cast<const Vertex *>(file.Data() + sizeof(ChunkHeader));
+    const void *indices = vertices + header.vertexCount;
+    GLenum indexType = header.indexSize == sizeof(uint16_t) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    chunk.mesh = new Mesh(vertices, header.vertexCount, indices, header.indexCount, indexType,
+                          BoundingVolume::FromBox(chunk.boundsMin, chunk.boundsMax), std::vector<Texture>());
+    return true;
+}
+
+void ChunkedMesh::PageOut(Chunk &chunk)
+{
+    delete chunk.mesh;
+    chunk.mesh = nullptr;
+}
+
+void ChunkedMesh::UpdateResidency(const glm::vec3 &center, float radius, size_t residentBudget, int maxLoads)
+{
+    // 与区域相交的块按距离由近到远排序
+    std::vector<std::pair<float, size_t>> candidates;
+    for (size_t i = 0; i < chunks.size(); i++)
+    {
+        glm::vec3 closest = glm::clamp(center, chunks[i].boundsMin, chunks[i].boundsMax);
+        float dist = glm::distance(center, closest);
+        if (dist <= radius)
+            candidates.push_back({dist, i});
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    std::vector<unsigned char> keep(chunks.size(), 0);
+    size_t used = 0;
+    int loads = 0;
+    for (const auto &candidate : candidates)
+    {
+        Chunk &chunk = chunks[candidate.second];
+        size_t bytes = ChunkBytes(chunk.vertexCount, chunk.indexCount);
+        if (used + bytes > residentBudget)
+            break;
+        if (!chunk.mesh)
+        {
+            if (loads >= maxLoads || !PageIn(chunk))
+                continue;
+            loads++;
+        }
+        keep[candidate.second] = 1;
+        used += bytes;
+    }
+
+    for (size_t i = 0; i < chunks.size(); i++)
+        if (!keep[i] && chunks[i].mesh)
+            PageOut(chunks[i]);
+}
+
+void ChunkedMesh::Draw(Shader &shader)
+{
+    for (auto &chunk : chunks)
+        if (chunk.mesh)
+            chunk.mesh->Draw(shader);
+}
+
+void ChunkedMesh::DrawDepth(Shader &shader)
+{
+    for (auto &chunk : chunks)
+        if (chunk.mesh)
+            chunk.mesh->DrawDepth(shader);
+}
+
+size_t ChunkedMesh::ResidentBytes() const
+{
+    size_t bytes = 0;
+    for (const auto &chunk : chunks)
+        if (chunk.mesh)
+            bytes += ChunkBytes(chunk.vertexCount, chunk.indexCount);
+    return bytes;
+}
+
+size_t ChunkedMesh::ResidentCount() const
+{
+    size_t count = 0;
+    for (const auto &chunk : chunks)
+        if (chunk.mesh)
+            count++;
+    return count;
+}
+
+// ---------------- StreamingImporter ----------------
+
+std::string StreamingImporter::OutputDirectory(const std::string &sourcePath)
+{
+    return sourcePath + ".chunks";
+}
+
+ChunkedMesh *StreamingImporter::Import(const std::string &path, const StreamingOptions &options, ImportProgress *progress)
+{
+    std::cout << "[StreamingImporter] Streaming import from: " << path << std::endl;
+    auto start = std::chrono::steady_clock::now();
+
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    if (!StatSource(path, sourceSize, sourceTime) || sourceSize == 0)
+    {
+        std::cerr << "[StreamingImporter] Cannot open file: " << path << std::endl;
+        return nullptr;
+    }
+
+    std::string dir = OutputDirectory(path);
+    std::string manifestPath = (fs::path(dir) / "manifest.bin").string();
+
+    // 源文件未变化时直接复用上次的分块结果
+    {
+        ManifestHeader header;
+        std::vector<ManifestEntry> entries;
+        if (ReadManifest(manifestPath, header, entries) && header.sourceSize == sourceSize && header.sourceTime == sourceTime)
+        {
+            std::cout << "[StreamingImporter] Reusing " << entries.size() << " chunks in " << dir << std::endl;
+            return ChunkedMesh::LoadManifest(manifestPath);
+        }
+    }
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    fs::create_directories(dir, ec);
+    if (ec)
+    {
+        std::cerr << "[StreamingImporter] Cannot create directory: " << dir << std::endl;
+        return nullptr;
+    }
+
+    auto cancelled = [&]()
+    {
+        if (progress && progress->IsCancelled())
+        {
+            std::error_code removeError;
+            fs::remove_all(dir, removeError);
+            std::cout << "[StreamingImporter] Import cancelled: " << path << std::endl;
+            return true;
+        }
+        return false;
+    };
+
+    const size_t budget = std::max(options.memoryBudget, MIN_BUDGET);
+    const std::string positionPath = (fs::path(dir) / "positions.tmp").string();
+    const std::string texCoordPath = (fs::path(dir) / "texcoords.tmp").string();
+    const std::string normalPath = (fs::path(dir) / "normals.tmp").string();
+    const std::string cornerPath = (fs::path(dir) / "corners.tmp").string();
+
+    // ---------------- 1. 按窗口读取并溢写属性与角点 ----------------
+    if (progress)
+        progress->BeginStage("Streaming", 0.0f, 0.5f);
+
+    size_t positionCount = 0, texCoordCount = 0, normalCount = 0, cornerCount = 0;
+    glm::vec3 boundsMin(0.0f), boundsMax(0.0f);
+    {
+        FILE *source = std::fopen(path.c_str(), "rb");
+        if (!source)
+            return nullptr;
+
+        // 解析结果约为窗口字节数的数倍，窗口取预算的 1/16
+        const size_t windowBytes = budget / 16;
+        std::vector<char> window(windowBytes);
+        ObjData section;
+        SpillWriter positionWriter, texCoordWriter, normalWriter, cornerWriter;
+        bool ok = positionWriter.Open(positionPath) && texCoordWriter.Open(texCoordPath) &&
+                  normalWriter.Open(normalPath) && cornerWriter.Open(cornerPath);
+
+        size_t carry = 0;
+        uint64_t bytesRead = 0;
+        bool eof = false;
+        while (ok && !eof)
+        {
+            size_t read = std::fread(window.data() + carry, 1, windowBytes - carry, source);
+            eof = read < windowBytes - carry;
+            size_t filled = carry + read;
+            bytesRead += read;
+
+            // 窗口末尾的不完整行留给下一个窗口（超过窗口长度的行只能截断）
+            size_t parseEnd = filled;
+            if (!eof)
+            {
+                size_t i = filled;
+                while (i > 0 && window[i - 1] != '\n')
+                    --i;
+                if (i > 0)
+                    parseEnd = i;
+            }
+
+            section.positions.clear();
+            section.texCoords.clear();
+            section.normals.clear();
+            section.corners.clear();
+            ObjParser::ParseSection(window.data(), window.data() + parseEnd, section, positionCount, texCoordCount, normalCount);
+
+            if (positionCount == 0 && !section.positions.empty())
+                boundsMin = boundsMax = section.positions[0];
+            for (const glm::vec3 &p : section.positions)
+            {
+                boundsMin = glm::min(boundsMin, p);
+                boundsMax = glm::max(boundsMax, p);
+            }
+            positionWriter.Write(section.positions.data(), section.positions.size() * sizeof(glm::vec3));
+            texCoordWriter.Write(section.texCoords.data(), section.texCoords.size() * sizeof(glm::vec2));
+            normalWriter.Write(section.normals.data(), section.normals.size() * sizeof(glm::vec3));
+            cornerWriter.Write(section.corners.data(), section.corners.size() * sizeof(ObjIndex));
+            positionCount += section.positions.size();
+            texCoordCount += section.texCoords.size();
+            normalCount += section.normals.size();
+            cornerCount += section.corners.size();
+
+            carry = filled - parseEnd;
+            std::memmove(window.data(), window.data() + parseEnd, carry);
+
+            if (progress)
+                progress->Report(static_cast<float>(bytesRead) / static_cast<float>(sourceSize));
+            if (cancelled())
+            {
+                std::fclose(source);
+                return nullptr;
+            }
+        }
+        std::fclose(source);
+        ok = positionWriter.Close() && ok;
+        ok = texCoordWriter.Close() && ok;
+        ok = normalWriter.Close() && ok;
+        ok = cornerWriter.Close() && ok;
+        if (!ok)
+        {
+            std::cerr << "[StreamingImporter] Failed to write spill files in " << dir << std::endl;
+            fs::remove_all(dir, ec);
+            return nullptr;
+        }
+    }
+
+    const size_t triangleCount = cornerCount / 3;
+    if (triangleCount == 0)
+    {
+        std::cerr << "[StreamingImporter] No triangles found in: " << path << std::endl;
+        fs::remove_all(dir, ec);
+        return nullptr;
+    }
+
+    // ---------------- 2. 按重心把三角形分配到空间网格单元 ----------------
+    if (progress)
+        progress->BeginStage("Binning", 0.5f, 0.3f);
+
+    const size_t chunkTriangles = std::max<size_t>(1024, std::min(options.chunkTriangles, budget / 2 / CHUNK_BYTES_PER_TRIANGLE));
+    const size_t cellBudget = budget / 4;
+    int gridSize = static_cast<int>(std::ceil(std::cbrt(2.0 * static_cast<double>(triangleCount) / chunkTriangles)));
+    int maxGridSize = std::max(1, static_cast<int>(std::cbrt(static_cast<double>(cellBudget / MIN_CELL_BUFFER_BYTES))));
+    gridSize = std::max(1, std::min(gridSize, maxGridSize));
+    const size_t cellCount = static_cast<size_t>(gridSize) * gridSize * gridSize;
+    const size_t cellCapacity = std::max<size_t>(3, cellBudget / cellCount / sizeof(CornerRecord) / 3 * 3);
+
+    glm::vec3 extent = glm::max(boundsMax - boundsMin, glm::vec3(1e-6f));
+    std::vector<CellBuffer> cells(cellCount);
+    {
+        PagedReader positionReader(positionPath, budget / 4);
+        PagedReader texCoordReader(texCoordPath, budget / 8);
+        PagedReader normalReader(normalPath, budget / 8);
+
+        FILE *cornerFile = std::fopen(cornerPath.c_str(), "rb");
+        if (!cornerFile)
+            return nullptr;
+        std::vector<ObjIndex> corners(3 * 65536);
+        size_t processed = 0;
+        bool ok = true;
+        size_t read;
+        while (ok && (read = std::fread(corners.data(), sizeof(ObjIndex), corners.size(), cornerFile)) > 0)
+        {
+            for (size_t i = 0; i + 2 < read; i += 3)
+            {
+                const ObjIndex *tri = &corners[i];
+                bool valid = true;
+                for (int k = 0; k < 3; k++)
+                    valid = valid && tri[k].v >= 0 && static_cast<size_t>(tri[k].v) < positionCount;
+                if (!valid)
+                    continue;
+
+                CornerRecord records[3];
+                glm::vec3 centroid(0.0f);
+                for (int k = 0; k < 3; k++)
+                {
+                    CornerRecord &record = records[k];
+                    record.key = tri[k];
+                    if (record.key.vt < 0 || static_cast<size_t>(record.key.vt) >= texCoordCount)
+                        record.key.vt = -1;
+                    if (record.key.vn < 0 || static_cast<size_t>(record.key.vn) >= normalCount)
+                        record.key.vn = -1;
+
+                    std::memcpy(&record.vertex.Position, positionReader.Get(static_cast<uint64_t>(record.key.v) * sizeof(glm::vec3)), sizeof(glm::vec3));
+                    record.vertex.TexCoords = glm::vec2(0.0f);
+                    record.vertex.Normal = glm::vec3(0.0f);
+                    if (record.key.vt >= 0)
+                        std::memcpy(&record.vertex.TexCoords, texCoordReader.Get(static_cast<uint64_t>(record.key.vt) * sizeof(glm::vec2)), sizeof(glm::vec2));
+                    if (record.key.vn >= 0)
+                        std::memcpy(&record.vertex.Normal, normalReader.Get(static_cast<uint64_t>(record.key.vn) * sizeof(glm::vec3)), sizeof(glm::vec3));
+                    centroid += record.vertex.Position;
+                }
+
+                glm::vec3 cellCoord = (centroid / 3.0f - boundsMin) / extent * static_cast<float>(gridSize);
+                int cx = std::min(gridSize - 1, std::max(0, static_cast<int>(cellCoord.x)));
+                int cy = std::min(gridSize - 1, std::max(0, static_cast<int>(cellCoord.y)));
+                int cz = std::min(gridSize - 1, std::max(0, static_cast<int>(cellCoord.z)));
+                size_t cellIndex = (static_cast<size_t>(cz) * gridSize + cy) * gridSize + cx;
+
+                CellBuffer &cell = cells[cellIndex];
+                if (cell.records.capacity() < cellCapacity)
+                    cell.records.reserve(cellCapacity);
+                cell.records.insert(cell.records.end(), records, records + 3);
+                if (cell.records.size() + 3 > cellCapacity)
+                    ok = FlushCell(dir, cellIndex, cell);
+            }
+
+            processed += read / 3;
+            if (progress)
+                progress->Report(static_cast<float>(processed) / static_cast<float>(triangleCount));
+            if (cancelled())
+            {
+                std::fclose(cornerFile);
+                return nullptr;
+            }
+        }
+        std::fclose(cornerFile);
+
+        for (size_t i = 0; i < cellCount && ok; i++)
+        {
+            ok = FlushCell(dir, i, cells[i]);
+            std::vector<CornerRecord>().swap(cells[i].records);
+        }
+        if (!ok)
+        {
+            std::cerr << "[StreamingImporter] Failed to write cell files in " << dir << std::endl;
+            fs::remove_all(dir, ec);
+            return nullptr;
+        }
+    }
+    fs::remove(positionPath, ec);
+    fs::remove(texCoordPath, ec);
+    fs::remove(normalPath, ec);
+    fs::remove(cornerPath, ec);
+
+    // ---------------- 3. 逐单元切成固定大小的块并去重 ----------------
+    if (progress)
+        progress->BeginStage("Writing chunks", 0.8f, 0.2f);
+
+    std::vector<ManifestEntry> entries;
+    std::vector<CornerRecord> records;
+    for (size_t i = 0; i < cellCount; i++)
+    {
+        if (!cells[i].hasFile)
+            continue;
+        std::string cellPath = CellPath(dir, i);
+        FILE *cellFile = std::fopen(cellPath.c_str(), "rb");
+        if (!cellFile)
+            continue;
+
+        bool ok = true;
+        while (ok)
+        {
+            records.resize(chunkTriangles * 3);
+            size_t read = std::fread(records.data(), sizeof(CornerRecord), records.size(), cellFile);
+            if (read < 3)
+                break;
+            records.resize(read / 3 * 3);
+
+            // 顶点数超过 65536 的块拆成多个，每块都能使用 16 位索引
+            for (size_t begin = 0; ok && begin < records.size();)
+            {
+                ManifestEntry entry;
+                size_t end = begin;
+                ok = WriteChunk(ChunkPath(dir, entries.size()), records, begin, end, entry);
+                if (ok)
+                    entries.push_back(entry);
+                begin = end;
+            }
+        }
+        std::fclose(cellFile);
+        fs::remove(cellPath, ec);
+        if (!ok)
+        {
+            std::cerr << "[StreamingImporter] Failed to write chunk files in " << dir << std::endl;
+            fs::remove_all(dir, ec);
+            return nullptr;
+        }
+
+        if (progress)
+            progress->Report(static_cast<float>(i + 1) / static_cast<float>(cellCount));
+        if (cancelled())
+            return nullptr;
+    }
+    std::vector<CornerRecord>().swap(records);
+
+    // 清单文件最后写入：存在即表示分块完整
+    ManifestHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MANIFEST_MAGIC, sizeof(MANIFEST_MAGIC));
+    header.version = MANIFEST_VERSION;
+    header.chunkCount = static_cast<uint32_t>(entries.size());
+    header.sourceSize = sourceSize;
+    header.sourceTime = sourceTime;
+    for (int k = 0; k < 3; k++)
+    {
+        header.boundsMin[k] = boundsMin[k];
+        header.boundsMax[k] = boundsMax[k];
+    }
+    FILE *manifest = std::fopen(manifestPath.c_str(), "wb");
+    bool ok = manifest && std::fwrite(&header, sizeof(header), 1, manifest) == 1 &&
+              std::fwrite(entries.data(), sizeof(ManifestEntry), entries.size(), manifest) == entries.size();
+    if (manifest)
+        ok = (std::fclose(manifest) == 0) && ok;
+    if (!ok)
+    {
+        std::cerr << "[StreamingImporter] Failed to write manifest: " << manifestPath << std::endl;
+        fs::remove_all(dir, ec);
+        return nullptr;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[StreamingImporter] " << triangleCount << " triangles -> " << entries.size() << " chunks ("
+              << gridSize << "^3 grid, <= " << chunkTriangles << " triangles each, budget "
+              << budget / (1024 * 1024) << " MB) in " << seconds << " s" << std::endl;
+
+    if (progress)
+        progress->BeginStage("Done", 1.0f, 0.0f);
+    return ChunkedMesh::LoadManifest(manifestPath);
+}
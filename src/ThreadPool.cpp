@@ -0,0 +1,101 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool &ThreadPool::Global()
+{
+    static ThreadPool pool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+    return pool;
+}
+
+ThreadPool::ThreadPool(unsigned int workerCount)
+{
+    workers.reserve(workerCount);
+    for (unsigned int i = 0; i < workerCount; i++)
+        workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this]
+                              { return stopping || !jobs.empty(); });
+            if (stopping && jobs.empty())
+                return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)> &task)
+{
+    if (count == 0)
+        return;
+    if (count == 1 || workers.empty())
+    {
+        for (size_t i = 0; i < count; i++)
+            task(i);
+        return;
+    }
+
+    // 共享状态由 shared_ptr 持有：排队较晚的辅助任务在循环结束后才启动也是安全的
+    struct State
+    {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+        const std::function<void(size_t)> *task;
+        size_t count;
+    };
+    auto state = std::make_shared<State>();
+    state->task = &task;
+    state->count = count;
+
+    auto run = [](State &s)
+    {
+        size_t i;
+        while ((i = s.next.fetch_add(1)) < s.count)
+        {
+            (*s.task)(i);
+            if (s.done.fetch_add(1) + 1 == s.count)
+            {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                s.finished.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min(workers.size(), count - 1);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t h = 0; h < helpers; h++)
+            jobs.emplace_back([state, run]
+                              { run(*state); });
+    }
+    jobAvailable.notify_all();
+
+    run(*state);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&]
+                         { return state->done.load() == count; });
+}
@@ -0,0 +1,185 @@
+#include "VertexPacker.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    inline float SignNotZero(float v)
+    {
+        return v >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    inline uint16_t QuantizeUnorm16(float v)
+    {
+        v = std::min(std::max(v, 0.0f), 1.0f);
+        return static_cast<uint16_t>(v * 65535.0f + 0.5f);
+    }
+
+    inline int16_t QuantizeSnorm16(float v)
+    {
+        v = std::min(std::max(v, -1.0f), 1.0f);
+        return static_cast<int16_t>(std::lround(v * 32767.0f));
+    }
+}
+
+glm::vec2 VertexPacker::OctEncode(const glm::vec3 &n)
+{
+    float l1 = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+    if (l1 <= 0.0f)
+        return glm::vec2(0.0f, 0.0f);
+    glm::vec2 e(n.x / l1, n.y / l1);
+    // 下半球折叠到外侧的四个三角形
+    if (n.z < 0.0f)
+        e = glm::vec2((1.0f - std::fabs(e.y)) * SignNotZero(e.x), (1.0f - std::fabs(e.x)) * SignNotZero(e.y));
+    return e;
+}
+
+glm::vec3 VertexPacker::OctDecode(const glm::vec2 &e)
+{
+    glm::vec3 n(e.x, e.y, 1.0f - std::fabs(e.x) - std::fabs(e.y));
+    float t = std::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return glm::normalize(n);
+}
+
+uint16_t VertexPacker::FloatToHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    uint32_t exponent = (bits >> 23) & 0xFFu;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (exponent == 0xFFu)
+        return sign | (mantissa ? 0x7E00u : 0x7C00u); // NaN / Inf
+    int e = static_cast<int>(exponent) - 127 + 15;
+    if (e >= 31)
+        return sign | 0x7BFFu; // 饱和到最大有限值
+    if (e <= 0)
+    {
+        // 非规格化数：带上隐含位后右移，就近舍入
+        if (e < -10)
+            return sign;
+        mantissa |= 0x800000u;
+        uint32_t shift = static_cast<uint32_t>(14 - e);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1u)))
+            half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+    uint32_t half = (static_cast<uint32_t>(e) << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFFu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u)))
+        half++; // 进位可能使指数加一，结果仍然正确
+    if (half >= 0x7C00u)
+        half = 0x7BFFu;
+    return static_cast<uint16_t>(sign | half);
+}
+
+float VertexPacker::HalfToFloat(uint16_t half)
+{
+    uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1Fu;
+    uint32_t mantissa = half & 0x3FFu;
+    uint32_t bits;
+    if (exponent == 0)
+    {
+        if (mantissa == 0)
+        {
+            bits = sign;
+        }
+        else
+        {
+            // 非规格化数转为单精度规格化数
+            int e = -1;
+            do
+            {
+                e++;
+                mantissa <<= 1;
+            } while ((mantissa & 0x400u) == 0);
+            bits = sign | (static_cast<uint32_t>(127 - 15 - e) << 23) | ((mantissa & 0x3FFu) << 13);
+        }
+    }
+    else if (exponent == 31)
+    {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    }
+    else
+    {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+VertexQuantization VertexPacker::Pack(const Vertex *vertices, size_t count, std::vector<PackedVertex> &out)
+{
+    VertexQuantization quantization;
+    out.resize(count);
+    if (count == 0)
+        return quantization;
+
+    glm::vec3 lo = vertices[0].Position, hi = lo;
+    for (size_t i = 1; i < count; i++)
+    {
+        lo = glm::min(lo, vertices[i].Position);
+        hi = glm::max(hi, vertices[i].Position);
+    }
+    quantization.offset = lo;
+    quantization.scale = hi - lo;
+    glm::vec3 inverse(quantization.scale.x > 0.0f ? 1.0f / quantization.scale.x : 0.0f,
+                      quantization.scale.y > 0.0f ? 1.0f / quantization.scale.y : 0.0f,
+                      quantization.scale.z > 0.0f ? 1.0f / quantization.scale.z : 0.0f);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const Vertex &v = vertices[i];
+        PackedVertex &p = out[i];
+        glm::vec3 t = (v.Position - lo) * inverse;
+        p.Position[0] = QuantizeUnorm16(t.x);
+        p.Position[1] = QuantizeUnorm16(t.y);
+        p.Position[2] = QuantizeUnorm16(t.z);
+        p.Position[3] = 0;
+        glm::vec2 e = OctEncode(v.Normal);
+        p.Normal[0] = QuantizeSnorm16(e.x);
+        p.Normal[1] = QuantizeSnorm16(e.y);
+        p.TexCoords[0] = FloatToHalf(v.TexCoords.x);
+        p.TexCoords[1] = FloatToHalf(v.TexCoords.y);
+    }
+    return quantization;
+}
+
+Vertex VertexPacker::Unpack(const PackedVertex &packed, const VertexQuantization &quantization)
+{
+    Vertex v;
+    glm::vec3 t(packed.Position[0] / 65535.0f, packed.Position[1] / 65535.0f, packed.Position[2] / 65535.0f);
+    v.Position = quantization.offset + t * quantization.scale;
+    v.Normal = OctDecode(glm::vec2(std::max(packed.Normal[0] / 32767.0f, -1.0f), std::max(packed.Normal[1] / 32767.0f, -1.0f)));
+    v.TexCoords = glm::vec2(HalfToFloat(packed.TexCoords[0]), HalfToFloat(packed.TexCoords[1]));
+    return v;
+}
+
+PackError VertexPacker::MeasureError(const Vertex *vertices, const PackedVertex *packed, size_t count,
+                                     const VertexQuantization &quantization)
+{
+    PackError error;
+    float minCosine = 1.0f;
+    for (size_t i = 0; i < count; i++)
+    {
+        Vertex decoded = Unpack(packed[i], quantization);
+        error.position = std::max(error.position, glm::length(decoded.Position - vertices[i].Position));
+        // 零长度法线编码后没有方向可比，跳过
+        float length = glm::length(vertices[i].Normal);
+        if (length > 0.0f)
+            minCosine = std::min(minCosine, glm::dot(decoded.Normal, vertices[i].Normal) / length);
+        glm::vec2 uv = decoded.TexCoords - vertices[i].TexCoords;
+        error.texCoord = std::max(error.texCoord, std::max(std::fabs(uv.x), std::fabs(uv.y)));
+    }
+    error.normalDegrees = glm::degrees(std::acos(glm::clamp(minCosine, -1.0f, 1.0f)));
+    return error;
+}